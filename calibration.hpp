@@ -0,0 +1,958 @@
+// Simple Uniform Noise
+//
+// Author: Yurii Blok
+// License: BSL-1.0
+// https://github.com/yurablok/simple-uniform-noise
+// History:
+// v0.1 2023-Jan-29     First release.
+
+#pragma once
+#ifndef SIMPLE_UNIFORM_NOISE_CALIBRATION
+#define SIMPLE_UNIFORM_NOISE_CALIBRATION
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "noise.hpp"
+#include "parallel.hpp"
+#include "polyfit.hpp"
+
+namespace noise {
+
+// The offset table calculation of calc() in processing/main.cpp without
+// the windows, and the solver that replaces its sampling.
+namespace calibration {
+
+constexpr size_t g_statisticsSize = 512;
+constexpr uint32_t g_tableRows = 10000;
+constexpr uint32_t g_offsetLines = 128;
+// Samples of the offset curve per table, the image width in calc() of
+// processing/main.cpp
+constexpr uint32_t g_resolution = 512;
+
+using histogram_t = std::array<uint32_t, g_statisticsSize>;
+
+struct table_t {
+    noise::offset_line_t lines[g_offsetLines + 1] = {};
+};
+
+enum class sequence_t {
+    random, // Counter-based: coordinate k of sample i is stream64(seed) value i * dims + k
+    sobol,  // Cell k of sample i from stream64(seed) value i * dims + k, position
+            // inside the cell from a Sobol sequence shifted by stream64(seed, 1)
+};
+
+struct sampling_t {
+    uint64_t seed = 1;
+    sequence_t sequence = sequence_t::random;
+    uint32_t cellSize = 64; // The period of the Sobol positions
+};
+
+// Sobol sequence in 32-bit fixed point, up to 8 dimensions.
+// Direction numbers from Joe & Kuo, new-joe-kuo-6.21201.
+template <uint32_t dims>
+class sobol_t {
+    static_assert(dims >= 1 && dims <= 8, "dims must be 1..8");
+public:
+    // The point with the given index, followed by index + 1, ... on next().
+    // The digital shift of dimension k is value k of stream64(seed, 1).
+    sobol_t(const uint64_t seed, const uint32_t index) noexcept : m_index(index) {
+        struct params_t {
+            uint32_t s;
+            uint32_t a;
+            uint32_t m[5];
+        };
+        static constexpr params_t params[8] = {
+            { 0, 0, { 0 } }, // van der Corput
+            { 1, 0, { 1 } },
+            { 2, 1, { 1, 3 } },
+            { 3, 1, { 1, 3, 1 } },
+            { 3, 2, { 1, 1, 1 } },
+            { 4, 1, { 1, 1, 3, 3 } },
+            { 4, 4, { 1, 3, 5, 13 } },
+            { 5, 2, { 1, 1, 5, 5, 17 } },
+        };
+        utils::stream64 shift(seed, 1);
+        for (uint32_t k = 0; k < dims; ++k) {
+            uint32_t* v = m_directions[k];
+            const params_t& p = params[k];
+            for (uint32_t j = 0; j < 32; ++j) {
+                if (k == 0) {
+                    v[j] = UINT32_C(1) << (31 - j);
+                }
+                else if (j < p.s) {
+                    v[j] = p.m[j] << (31 - j);
+                }
+                else {
+                    v[j] = v[j - p.s] ^ (v[j - p.s] >> p.s);
+                    for (uint32_t i = 1; i < p.s; ++i) {
+                        v[j] ^= ((p.a >> (p.s - 1 - i)) & 1) * v[j - i];
+                    }
+                }
+            }
+            // A random digital shift keeps the low discrepancy.
+            m_point[k] = static_cast<uint32_t>(shift() >> 32);
+            const uint32_t gray = index ^ (index >> 1);
+            for (uint32_t j = 0; j < 32; ++j) {
+                if ((gray >> j) & 1) {
+                    m_point[k] ^= v[j];
+                }
+            }
+        }
+    }
+    const uint32_t (&point() const noexcept)[dims] {
+        return m_point;
+    }
+    void next() noexcept {
+        // Gray code order: flip the direction of the lowest zero bit of the index.
+        uint32_t j = 0;
+        while ((m_index >> j) & 1) {
+            ++j;
+        }
+        ++m_index;
+        for (uint32_t k = 0; k < dims; ++k) {
+            m_point[k] ^= m_directions[k][j & 31];
+        }
+    }
+private:
+    uint32_t m_directions[dims][32];
+    uint32_t m_point[dims];
+    uint32_t m_index;
+};
+
+// Step 1 and Step 6. Collection of the distribution statistics.
+// sample(const uint64_t (&p)[dims]) must be thread-safe. The work is split
+// into fixed chunks with a histogram each, summed in chunk order, so the
+// result does not depend on the number of threads.
+template <uint32_t dims, typename sample_t>
+histogram_t collect(noise::thread_pool& pool, const uint64_t reps,
+        const sampling_t& sampling, sample_t&& sample) {
+    constexpr uint64_t chunk = 1 << 20;
+    const size_t chunks = static_cast<size_t>((reps + chunk - 1) / chunk);
+    std::vector<histogram_t> counts(chunks);
+    pool.run(chunks, [&](const size_t idx) {
+        histogram_t& count = counts[idx];
+        count.fill(0);
+        const uint64_t begin = idx * chunk;
+        const uint64_t end = std::min(reps, begin + chunk);
+        constexpr uint32_t size = UINT32_MAX / g_statisticsSize + 1;
+        if (sampling.sequence == sequence_t::random) {
+            constexpr uint32_t block = 256;
+            uint64_t points[block][dims];
+            utils::stream64 stream(sampling.seed);
+            stream.seek(begin * dims);
+            for (uint64_t i = begin; i < end; i += block) {
+                const uint32_t n = static_cast<uint32_t>(std::min<uint64_t>(block, end - i));
+                stream.fill(points[0], size_t(n) * dims);
+                for (uint32_t j = 0; j < n; ++j) {
+                    ++count[sample(points[j]) / size];
+                }
+            }
+        }
+        else {
+            sobol_t<dims> sobol(sampling.seed, static_cast<uint32_t>(begin));
+            utils::stream64 cells(sampling.seed);
+            cells.seek(begin * dims);
+            uint64_t p[dims];
+            for (uint64_t i = begin; i < end; ++i, sobol.next()) {
+                for (uint32_t k = 0; k < dims; ++k) {
+                    // Cells up to 2^40 keep the coordinates away from the wrap.
+                    const uint64_t cell = cells() >> 24;
+                    const uint64_t position = (uint64_t(sobol.point()[k]) * sampling.cellSize) >> 32;
+                    p[k] = cell * sampling.cellSize + position;
+                }
+                ++count[sample(p) / size];
+            }
+        }
+    });
+    histogram_t count = { 0 };
+    for (const histogram_t& part : counts) {
+        for (size_t i = 0; i < count.size(); ++i) {
+            count[i] += part[i];
+        }
+    }
+    return count;
+}
+
+struct uniformity_t {
+    double maxDeviation = 0.0; // max |count / average - 1|
+    double rmsDeviation = 0.0;
+};
+
+inline uniformity_t measure(const histogram_t& count) {
+    double total = 0.0;
+    for (const uint32_t c : count) {
+        total += c;
+    }
+    const double average = total / count.size();
+    uniformity_t result;
+    for (const uint32_t c : count) {
+        const double deviation = c / average - 1.0;
+        result.maxDeviation = std::max(result.maxDeviation, std::abs(deviation));
+        result.rmsDeviation += deviation * deviation;
+    }
+    result.rmsDeviation = std::sqrt(result.rmsDeviation / count.size());
+    return result;
+}
+
+// Steps 2-4. The offset curve over [0, UINT32_MAX / 2]
+template <uint8_t degree>
+utils::Polyfit<double, degree> fitOffsets(const histogram_t& count) {
+    // Step 2. Polynomial regression 1
+    utils::Polyfit<double, 6> polyfit;
+    for (size_t x = 0; x < count.size() / 2; ++x) {
+        // 0  x  count-1
+        // 0  h   U32/2
+        const uint32_t h = utils::lerp_u32(
+            static_cast<uint32_t>(x), count.size() / 2 - 1, UINT32_MAX / 2);
+        polyfit.add(h, count[x]);
+    }
+
+    // Step 3. Building the distribution table
+    const auto polynomial = polyfit.polynomial();
+    const double yMax = polynomial.y(UINT32_MAX / 2);
+    const auto height = [&](const uint32_t row) {
+        const uint32_t x = utils::lerp_u32(
+            1, row, g_tableRows,
+            0, UINT32_MAX / 2
+        );
+        return static_cast<uint32_t>(std::max(0.0, utils::lerp_f64(
+            0, polynomial.y(x), yMax,
+            1, g_tableRows
+        )));
+    };
+    uint32_t countTotal = 0;
+    for (uint32_t row = 1; row <= g_tableRows; ++row) {
+        countTotal += height(row);
+    }
+    const double heightAverage = static_cast<double>(countTotal) / g_tableRows;
+
+    // Step 4. Calculating offsets
+    struct RowMeta {
+        uint32_t aOffset = 0;
+        uint32_t bOffset = 0;
+        uint32_t aCount = 0;
+        uint32_t bCount = 0;
+    };
+    std::vector<RowMeta> offsets(g_tableRows);
+    uint32_t countRow = 0;
+    countTotal = 0;
+    uint32_t rowNew = 1;
+    for (uint32_t rowSrc = 1; rowSrc <= g_tableRows; ++rowSrc) {
+        const uint32_t h = height(rowSrc);
+        auto& offset = offsets[rowSrc - 1];
+        offset.aOffset = rowSrc - rowNew;
+        uint32_t countBegin = countRow;
+        for (uint32_t i = 0; i < h; ++i) {
+            ++countRow;
+            ++countTotal;
+            if (countTotal >= heightAverage * static_cast<double>(rowNew)) {
+                if (offset.aCount == 0) {
+                    offset.aCount = countRow - countBegin;
+                }
+                countRow = 0;
+                countBegin = 0;
+                ++rowNew;
+                offset.bOffset = rowSrc - rowNew;
+            }
+        }
+        offset.bCount = countRow - countBegin;
+    }
+
+    utils::Polyfit<double, degree> result;
+    for (uint32_t row = 1; row <= g_tableRows; ++row) {
+        const auto& offset = offsets[row - 1];
+        float abOffset = 0.0f;
+        if (offset.aCount != 0 && offset.bCount != 0) {
+            const float b3 = static_cast<float>(offset.aCount + offset.bCount);
+            const float c1 = static_cast<float>(offset.aCount) / b3;
+            const float c2 = static_cast<float>(offset.bCount) / b3;
+            const float d1 = static_cast<float>(offset.aOffset) + c1;
+            const float d2 = static_cast<float>(offset.bOffset) - c2;
+            abOffset = (d1 + d2) * 0.5f;
+        }
+        else {
+            abOffset = static_cast<float>(offset.aOffset);
+        }
+        const double x = utils::lerp_f64(
+            1, row, g_tableRows,
+            0, UINT32_MAX / 2
+        );
+        // 0  abOffset  g_tableRows-1
+        // 0     y         U32/2
+        const double y = utils::lerp_f64(
+            0, abOffset, g_tableRows - 1,
+            0, UINT32_MAX / 2
+        );
+        result.add(x, y);
+    }
+    return result;
+}
+
+// Step 5. Building the offsets table
+// overflows: the number of slopes with |slope| > UINT32_MAX, if not null.
+// continuous: the lines meet at the segment bounds.
+template <uint8_t degree>
+table_t buildTable(const utils::Polyfit<double, degree>& offsets, uint32_t* overflows = nullptr,
+        const bool continuous = false) {
+    constexpr double k = UINT64_C(1) << 31;
+    constexpr uint32_t size = UINT32_MAX / 2 / g_offsetLines + 1;
+    std::vector<double> knots(g_offsetLines + 1);
+    for (uint32_t i = 0; i <= g_offsetLines; ++i) {
+        knots[i] = static_cast<double>(i) * size;
+    }
+    utils::SegmentedLinefit<double> fit(std::move(knots));
+    std::array<double, g_resolution> xs;
+    std::array<double, g_resolution> ys;
+    for (uint32_t x = 0; x < g_resolution; ++x) {
+        // 0  x  resolution
+        // 0  xx  U32/2
+        xs[x] = utils::lerp_u32(x, g_resolution, UINT32_MAX / 2);
+    }
+    offsets.polynomial().y(xs, ys);
+    for (uint32_t x = 0; x < g_resolution; ++x) {
+        const uint32_t xx = static_cast<uint32_t>(xs[x]);
+        const uint32_t yy = static_cast<uint32_t>(std::max(0.0, ys[x]));
+        fit.add(xx / size, xx, yy);
+    }
+    const auto lines = continuous ? fit.continuousLines() : fit.lines();
+    table_t table;
+    for (uint32_t i = 0; i < g_offsetLines; ++i) {
+        // A negative offset would wrap: such a line is refit through its ends
+        // clamped to at least 1 for the rounding.
+        const double x0 = static_cast<double>(i) * size;
+        const double x1 = std::min(x0 + size - 1, static_cast<double>(UINT32_MAX / 2));
+        const double y0 = lines[i].intercept + lines[i].slope * x0;
+        const double y1 = lines[i].intercept + lines[i].slope * x1;
+        const bool clamped = std::min(y0, y1) < 1.0;
+        const double slope = clamped
+            ? (std::max(y1, 1.0) - std::max(y0, 1.0)) / (x1 - x0)
+            : lines[i].slope;
+        const int64_t w1i = static_cast<int64_t>(slope * k);
+        if (overflows != nullptr && static_cast<uint64_t>(std::abs(w1i)) > UINT32_MAX) {
+            ++*overflows;
+        }
+        double intercept = lines[i].intercept;
+        if (clamped) {
+            const double rounded = static_cast<double>(w1i) / k;
+            intercept = std::ceil(std::max(std::max(y0, 1.0) - rounded * x0,
+                std::max(y1, 1.0) - rounded * x1));
+        }
+        table.lines[i] = { w1i, static_cast<int64_t>(intercept) };
+    }
+    table.lines[g_offsetLines] = { 0, 0 };
+    return table;
+}
+
+// Step 5 with adaptive breakpoints: the offset curve split greedily into
+// least-squares lines, each as wide as the max error allows.
+namespace detail {
+    constexpr uint32_t g_segmentSamples = 1 << 14;
+
+    class segmenter_t {
+    public:
+        template <uint8_t degree>
+        explicit segmenter_t(const utils::Polyfit<double, degree>& offsets) {
+            // Curve samples with x normalized to [0, 1] and prefix sums for the fits
+            m_y.resize(g_segmentSamples + 1);
+            m_sums.resize(g_segmentSamples + 2);
+            for (uint32_t i = 0; i <= g_segmentSamples; ++i) {
+                m_y[i] = static_cast<double>(i) / g_segmentSamples * (UINT32_MAX / 2);
+            }
+            offsets.polynomial().y(m_y, m_y);
+            for (uint32_t i = 0; i <= g_segmentSamples; ++i) {
+                const double u = static_cast<double>(i) / g_segmentSamples;
+                m_y[i] = std::max(0.0, m_y[i]);
+                sums_t& next = m_sums[i + 1];
+                next = m_sums[i];
+                next.n += 1.0;
+                next.u += u;
+                next.uu += u * u;
+                next.y += m_y[i];
+                next.uy += u * m_y[i];
+            }
+        }
+
+        // Breakpoints as sample indices, the last one is g_segmentSamples + 1.
+        std::vector<uint32_t> split(const double maxError) const {
+            std::vector<uint32_t> begins;
+            uint32_t begin = 0;
+            while (begin <= g_segmentSamples) {
+                begins.push_back(begin);
+                // The largest end with the error in bounds, a line of two
+                // samples is exact.
+                uint32_t lo = std::min(begin + 2, g_segmentSamples + 1);
+                uint32_t hi = g_segmentSamples + 1;
+                while (lo < hi) {
+                    const uint32_t mid = (lo + hi + 1) / 2;
+                    if (error(begin, mid) <= maxError) {
+                        lo = mid;
+                    }
+                    else {
+                        hi = mid - 1;
+                    }
+                }
+                begin = lo;
+            }
+            return begins;
+        }
+
+        // Least-squares line y = a + b * u over samples [begin, end)
+        void fit(const uint32_t begin, const uint32_t end, double& a, double& b) const {
+            const sums_t& s0 = m_sums[begin];
+            const sums_t& s1 = m_sums[end];
+            const double n = s1.n - s0.n;
+            const double su = s1.u - s0.u;
+            const double suu = s1.uu - s0.uu;
+            const double sy = s1.y - s0.y;
+            const double suy = s1.uy - s0.uy;
+            const double det = n * suu - su * su;
+            if (n < 2.0 || det <= 0.0) {
+                a = sy / n;
+                b = 0.0;
+                return;
+            }
+            b = (n * suy - su * sy) / det;
+            a = (sy - b * su) / n;
+        }
+        double error(const uint32_t begin, const uint32_t end) const {
+            double a = 0.0;
+            double b = 0.0;
+            fit(begin, end, a, b);
+            double result = 0.0;
+            for (uint32_t i = begin; i < end; ++i) {
+                const double u = static_cast<double>(i) / g_segmentSamples;
+                result = std::max(result, std::abs(a + b * u - m_y[i]));
+            }
+            return result;
+        }
+
+    private:
+        struct sums_t {
+            double n = 0.0;
+            double u = 0.0;
+            double uu = 0.0;
+            double y = 0.0;
+            double uy = 0.0;
+        };
+        std::vector<double> m_y;
+        std::vector<sums_t> m_sums;
+    };
+} // namespace detail
+
+// Segments with at most maxError (in offset units) against the curve.
+// Returns false if that needs more than segments - 1 lines.
+template <size_t segments, uint8_t degree>
+bool buildSegments(const utils::Polyfit<double, degree>& offsets, const double maxError,
+        offset_segments_t<segments>& table) {
+    const detail::segmenter_t segmenter(offsets);
+    const std::vector<uint32_t> begins = segmenter.split(maxError);
+    if (begins.size() > segments - 1) {
+        return false;
+    }
+    constexpr double k = UINT64_C(1) << 31;
+    constexpr double scale = static_cast<double>(UINT32_MAX / 2) / detail::g_segmentSamples;
+    for (size_t i = 0; i < segments; ++i) {
+        table.begin[i] = UINT32_MAX;
+        table.lines[i] = { 0, 0 };
+    }
+    for (size_t i = 0; i < begins.size(); ++i) {
+        const uint32_t end = i + 1 < begins.size() ? begins[i + 1] : detail::g_segmentSamples + 1;
+        double a = 0.0;
+        double b = 0.0;
+        segmenter.fit(begins[i], end, a, b);
+        // A negative offset would wrap, keep at least 1 for the rounding.
+        const double low = std::min(a + b * begins[i] / detail::g_segmentSamples,
+            a + b * end / detail::g_segmentSamples);
+        if (low < 1.0) {
+            a += 1.0 - low;
+        }
+        // y = a + b * x / (UINT32_MAX / 2)
+        table.begin[i] = static_cast<uint32_t>(std::llround(begins[i] * scale));
+        table.lines[i] = {
+            static_cast<int64_t>(std::llround(b / (UINT32_MAX / 2) * k)),
+            static_cast<int64_t>(std::llround(a))
+        };
+        // The lines are fitted independently, an offset stepping up at the
+        // bound would step the corrected value back.
+        if (i > 0) {
+            const uint32_t previous = getOffsetU32(table.lines[i - 1], table.begin[i] - 1);
+            const uint32_t current = getOffsetU32(table.lines[i], table.begin[i]);
+            if (current > previous + 1) {
+                table.lines[i].intercept -= current - previous - 1;
+            }
+        }
+    }
+    table.begin[begins.size()] = UINT32_MAX / 2 + 1;
+    return true;
+}
+
+// The smallest max error that fits into the segments, written to maxError
+// if not null.
+template <size_t segments, uint8_t degree>
+offset_segments_t<segments> buildSegments(const utils::Polyfit<double, degree>& offsets,
+        double* maxError = nullptr) {
+    const detail::segmenter_t segmenter(offsets);
+    double lo = 0.0;
+    double hi = UINT32_MAX / 2;
+    for (uint32_t i = 0; i < 64; ++i) {
+        const double mid = (lo + hi) / 2;
+        (segmenter.split(mid).size() <= segments - 1 ? hi : lo) = mid;
+    }
+    offset_segments_t<segments> table;
+    buildSegments(offsets, hi, table);
+    if (maxError != nullptr) {
+        *maxError = hi;
+    }
+    return table;
+}
+
+// The distribution of the raw value computed from its Fourier series instead
+// of sampling. For a fixed position t in the cell the value is sum(w_i * U_i)
+// over 2^dims independent uniform corner hashes with the multilinear weights
+// w_i(t), sum(w_i) = 1. On [0, 1) its Fourier coefficients are real:
+//   c_k = (-1)^k * E_t[prod_i sinc(pi * k * w_i)]
+// The shifts of valueShifted move the positions in the cell but keep them
+// uniformly distributed, so the same histogram is used for dims > 1.
+
+constexpr uint32_t g_solverTerms = 8 * g_statisticsSize;
+constexpr uint32_t g_solverDims = 8;
+
+namespace detail {
+    // Representative positions of one axis over [0, 1/2] with their weights.
+    // t and 1 - t give the same weights, so only one half is enumerated.
+    // Exact for cells with up to 2 * maxPositions positions, midpoint rule
+    // over [0, 1/2] beyond that.
+    inline void axisPositions(const uint32_t cellSize, const uint32_t maxPositions,
+            std::vector<double>& t, std::vector<double>& weight) {
+        t.clear();
+        weight.clear();
+        if ((cellSize + 1) / 2 <= maxPositions) {
+            for (uint32_t j = 0; j < (cellSize + 1) / 2; ++j) {
+                t.push_back(static_cast<double>(j) / (cellSize - 1));
+                weight.push_back(2 * j + 1 == cellSize ? 1.0 : 2.0);
+            }
+        }
+        else {
+            for (uint32_t j = 0; j < maxPositions; ++j) {
+                t.push_back((j + 0.5) / (2.0 * maxPositions));
+                weight.push_back(static_cast<double>(cellSize) / maxPositions);
+            }
+        }
+    }
+
+    // Number of sorted index tuples over axes sorted by cell size, where axes
+    // of equal size form a group with non-decreasing indices.
+    inline double tupleCount(const uint32_t* cellSizes, const uint32_t dims,
+            const uint32_t maxPositions) {
+        double count = 1.0;
+        for (uint32_t k = 0, inGroup = 0; k < dims; ++k) {
+            inGroup = k > 0 && cellSizes[k] == cellSizes[k - 1] ? inGroup + 1 : 1;
+            const double positions = std::min((cellSizes[k] + 1) / 2, maxPositions);
+            // C(positions + inGroup - 1, inGroup) built one factor at a time
+            count *= (positions + inGroup - 1) / inGroup;
+        }
+        return count;
+    }
+
+    // Adds weight * prod_i sinc(pi * k * w_i) to coefs[k - 1], k = 1..terms.
+    inline void addProduct(const std::vector<double>& w, const double weight,
+            std::vector<double>& coefs) {
+        constexpr double pi = 3.14159265358979323846;
+        // sin(pi * k * w) by the recurrence s[k + 1] = 2 cos(pi * w) s[k] - s[k - 1]
+        std::vector<double> sPrev;
+        std::vector<double> sCur;
+        std::vector<double> twoCos;
+        std::vector<double> invPiW;
+        for (const double wi : w) {
+            if (wi <= 0.0) {
+                continue; // sinc(0) = 1
+            }
+            sPrev.push_back(0.0);
+            sCur.push_back(std::sin(pi * wi));
+            twoCos.push_back(2.0 * std::cos(pi * wi));
+            invPiW.push_back(1.0 / (pi * wi));
+        }
+        const size_t n = sCur.size();
+        for (uint32_t k = 1; k <= coefs.size(); ++k) {
+            const double invK = 1.0 / k;
+            double product = weight;
+            for (size_t i = 0; i < n; ++i) {
+                product *= sCur[i] * invPiW[i] * invK;
+                const double sNext = twoCos[i] * sCur[i] - sPrev[i];
+                sPrev[i] = sCur[i];
+                sCur[i] = sNext;
+            }
+            coefs[k - 1] += product;
+        }
+    }
+} // namespace detail
+
+// Fourier coefficients c_1..c_K of the density of the raw value of the
+// dims-dimensional noise with the given cell sizes, dims = 1..8.
+inline std::vector<double> solveSeries(thread_pool& pool,
+        const uint32_t* cellSizes_, const uint32_t dims) {
+    // The distribution does not depend on the axis order.
+    std::vector<uint32_t> cellSizes(cellSizes_, cellSizes_ + dims);
+    std::sort(cellSizes.begin(), cellSizes.end());
+
+    // Positions per axis such that there are at most ~6.5e4 tuples
+    uint32_t maxPositions = 4096;
+    while (maxPositions > 2 && detail::tupleCount(cellSizes.data(), dims, maxPositions) > 65536.0) {
+        --maxPositions;
+    }
+    std::vector<double> t[g_solverDims];
+    std::vector<double> axisWeight[g_solverDims];
+    for (uint32_t k = 0; k < dims; ++k) {
+        detail::axisPositions(cellSizes[k], maxPositions, t[k], axisWeight[k]);
+    }
+
+    struct tuple_t {
+        uint32_t idx[g_solverDims];
+        double weight;
+    };
+    std::vector<tuple_t> tuples;
+    tuple_t tuple = {};
+    const auto enumerate = [&](const auto& self, const uint32_t axis) -> void {
+        if (axis == dims) {
+            // Number of distinct orderings in each group times the axis weights
+            double weight = 1.0;
+            for (uint32_t k = 0, inGroup = 0, run = 0; k < dims; ++k) {
+                const bool sameGroup = k > 0 && cellSizes[k] == cellSizes[k - 1];
+                inGroup = sameGroup ? inGroup + 1 : 1;
+                run = sameGroup && tuple.idx[k] == tuple.idx[k - 1] ? run + 1 : 1;
+                weight *= axisWeight[k][tuple.idx[k]] * inGroup / run;
+            }
+            tuple.weight = weight;
+            tuples.push_back(tuple);
+            return;
+        }
+        const bool sameGroup = axis > 0 && cellSizes[axis] == cellSizes[axis - 1];
+        const uint32_t from = sameGroup ? tuple.idx[axis - 1] : 0;
+        for (uint32_t i = from; i < t[axis].size(); ++i) {
+            tuple.idx[axis] = i;
+            self(self, axis + 1);
+        }
+    };
+    enumerate(enumerate, 0);
+
+    // Fixed chunks summed in order, independent of the number of threads.
+    constexpr size_t chunk = 256;
+    const size_t chunks = (tuples.size() + chunk - 1) / chunk;
+    std::vector<std::vector<double>> parts(chunks);
+    pool.run(chunks, [&](const size_t idx) {
+        std::vector<double>& coefs = parts[idx];
+        coefs.assign(g_solverTerms, 0.0);
+        std::vector<double> w(size_t(1) << dims);
+        for (size_t j = idx * chunk; j < std::min(tuples.size(), (idx + 1) * chunk); ++j) {
+            for (uint32_t corner = 0; corner < w.size(); ++corner) {
+                w[corner] = 1.0;
+                for (uint32_t k = 0; k < dims; ++k) {
+                    const double tk = t[k][tuples[j].idx[k]];
+                    w[corner] *= ((corner >> k) & 1) ? tk : 1.0 - tk;
+                }
+            }
+            detail::addProduct(w, tuples[j].weight, coefs);
+        }
+    });
+    std::vector<double> coefs(g_solverTerms, 0.0);
+    double total = 0.0;
+    for (const tuple_t& tuple_ : tuples) {
+        total += tuple_.weight;
+    }
+    for (const std::vector<double>& part : parts) {
+        for (uint32_t k = 0; k < g_solverTerms; ++k) {
+            coefs[k] += part[k];
+        }
+    }
+    for (uint32_t k = 0; k < g_solverTerms; ++k) {
+        coefs[k] *= ((k + 1) & 1 ? -1.0 : 1.0) / total;
+    }
+    return coefs;
+}
+
+// Probability of each histogram bin of the series.
+inline std::array<double, g_statisticsSize> toBins(const std::vector<double>& coefs) {
+    // Integral of the series over [b / B, (b + 1) / B)
+    constexpr double pi = 3.14159265358979323846;
+    std::array<double, g_statisticsSize> bins;
+    for (uint32_t b = 0; b < g_statisticsSize; ++b) {
+        double mass = 1.0 / g_statisticsSize;
+        for (uint32_t k = 1; k <= g_solverTerms; ++k) {
+            const double x0 = 2.0 * pi * k * b / g_statisticsSize;
+            const double x1 = 2.0 * pi * k * (b + 1) / g_statisticsSize;
+            mass += coefs[k - 1] * (std::sin(x1) - std::sin(x0)) / (pi * k);
+        }
+        bins[b] = mass;
+    }
+    return bins;
+}
+// Probability of each histogram bin for the raw value of the dims-dimensional
+// noise with the given cell sizes, dims = 1..8.
+inline std::array<double, g_statisticsSize> solve(thread_pool& pool,
+        const uint32_t* cellSizes, const uint32_t dims) {
+    return toBins(solveSeries(pool, cellSizes, dims));
+}
+// Isotropic cells
+inline std::array<double, g_statisticsSize> solve(thread_pool& pool,
+        const uint32_t dims, const uint32_t cellSize) {
+    uint32_t cellSizes[g_solverDims];
+    std::fill(cellSizes, cellSizes + g_solverDims, cellSize);
+    return solve(pool, cellSizes, dims);
+}
+
+// The solved distribution as the histogram of the given number of samples.
+inline histogram_t toHistogram(const std::array<double, g_statisticsSize>& bins,
+        const uint64_t reps) {
+    histogram_t count;
+    for (size_t i = 0; i < bins.size(); ++i) {
+        count[i] = static_cast<uint32_t>(std::llround(std::max(0.0, bins[i]) * reps));
+    }
+    return count;
+}
+
+// The quantile table from the series: CDF(x) = x + sum c_k sin(2 pi k x) / (pi k).
+// The truncated series resolves about 1 / (2 * g_solverTerms), finer tables
+// only interpolate it. Made non-decreasing where the truncation ripples.
+template <uint32_t bits>
+void buildQuantiles(thread_pool& pool, const std::vector<double>& coefs,
+        quantile_table_t<bits>& table) {
+    constexpr double pi = 3.14159265358979323846;
+    constexpr uint32_t chunk = 1024;
+    std::vector<double> cdf(table.knots);
+    pool.run((table.knots + chunk - 1) / chunk, [&](const size_t idx) {
+        const uint32_t end = std::min<uint32_t>(table.knots, static_cast<uint32_t>(idx + 1) * chunk);
+        for (uint32_t i = static_cast<uint32_t>(idx) * chunk; i < end; ++i) {
+            const double x = std::ldexp(static_cast<double>(i), -static_cast<int32_t>(bits));
+            // sin(k * theta) by the Chebyshev recurrence
+            const double theta = 2.0 * pi * x;
+            const double twoCos = 2.0 * std::cos(theta);
+            double sinPrev = 0.0;
+            double sinCur = std::sin(theta);
+            double sum = x;
+            for (uint32_t k = 1; k <= coefs.size(); ++k) {
+                sum += coefs[k - 1] * sinCur / (pi * k);
+                const double sinNext = twoCos * sinCur - sinPrev;
+                sinPrev = sinCur;
+                sinCur = sinNext;
+            }
+            cdf[i] = sum;
+        }
+    });
+    double running = 0.0;
+    for (uint32_t i = 0; i < table.knots; ++i) {
+        running = std::clamp(cdf[i], running, 1.0);
+        table.cdf[i] = static_cast<uint32_t>(std::min(std::ldexp(running, 32), double(UINT32_MAX)));
+    }
+    table.cdf[0] = 0;
+    table.cdf[table.knots - 1] = UINT32_MAX;
+}
+// The quantile table from collected statistics, linear inside each bin.
+template <uint32_t bits>
+void buildQuantiles(const histogram_t& count, quantile_table_t<bits>& table) {
+    std::array<double, g_statisticsSize + 1> cdf = { 0.0 };
+    for (size_t i = 0; i < count.size(); ++i) {
+        cdf[i + 1] = cdf[i] + count[i];
+    }
+    for (uint32_t i = 0; i < table.knots; ++i) {
+        const double x = std::ldexp(static_cast<double>(i), -static_cast<int32_t>(bits)) * g_statisticsSize;
+        const size_t bin = std::min<size_t>(static_cast<size_t>(x), g_statisticsSize - 1);
+        const double value = (cdf[bin] + (cdf[bin + 1] - cdf[bin]) * (x - bin)) / cdf.back();
+        table.cdf[i] = static_cast<uint32_t>(std::min(std::ldexp(value, 32), double(UINT32_MAX)));
+    }
+}
+
+// Steps 1-5 with the solver: the offsets table for the given cell sizes.
+inline table_t solveTable(thread_pool& pool, const uint32_t* cellSizes, const uint32_t dims) {
+    const histogram_t count = toHistogram(solve(pool, cellSizes, dims), 100'000'000);
+    if (dims == 1) {
+        return buildTable(fitOffsets<5>(count));
+    }
+    return buildTable(fitOffsets<6>(count));
+}
+} // namespace calibration
+
+// Offset tables calibrated on first use for arbitrary cell sizes, e.g. the
+// small cells where the lerp quantization changes the distribution. The
+// tables are kept in memory and, if a file is opened, persisted to it.
+class table_cache {
+public:
+    using table_t = calibration::table_t;
+
+    table_cache() = default;
+    // Loads the tables of the file and saves the new ones to it.
+    explicit table_cache(std::string path) {
+        open(std::move(path));
+    }
+    table_cache(const table_cache&) = delete;
+    table_cache& operator=(const table_cache&) = delete;
+
+    // Returns false if the file exists but is not a cache of this version.
+    bool open(std::string path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_path = std::move(path);
+        return load();
+    }
+
+    // The reference stays valid for the lifetime of the cache. A missing
+    // table is solved outside the lock, so the lookups of other threads do
+    // not wait for it; the solves share one pool and run one at a time.
+    // Threads solving the same key concurrently get the first inserted table.
+    const table_t& get(const uint32_t* cellSizes, const uint32_t dims) {
+        key_t key(cellSizes, cellSizes + dims);
+        std::sort(key.begin(), key.end());
+        thread_pool* pool = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_tables.find(key);
+            if (it != m_tables.end()) {
+                return *it->second;
+            }
+            if (!m_pool) {
+                m_pool = std::make_unique<thread_pool>();
+            }
+            pool = m_pool.get();
+        }
+        auto table = std::make_unique<table_t>(calibration::solveTable(*pool, key.data(), dims));
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto [it, inserted] = m_tables.emplace(std::move(key), std::move(table));
+        if (inserted && !m_path.empty()) {
+            save();
+        }
+        return *it->second;
+    }
+    const table_t& get(const int1d& noise) {
+        return get(&noise.cellSize, 1);
+    }
+    const table_t& get(const int2d& noise) {
+        const uint32_t cellSizes[] = { noise.cellSize.x, noise.cellSize.y };
+        return get(cellSizes, 2);
+    }
+    const table_t& get(const int3d& noise) {
+        const uint32_t cellSizes[] = { noise.cellSize.x, noise.cellSize.y, noise.cellSize.z };
+        return get(cellSizes, 3);
+    }
+    const table_t& get(const int4d& noise) {
+        const uint32_t cellSizes[] = {
+            noise.cellSize.x, noise.cellSize.y, noise.cellSize.z, noise.cellSize.w };
+        return get(cellSizes, 4);
+    }
+
+    // In-memory cache of the process.
+    static table_cache& global() {
+        static table_cache cache;
+        return cache;
+    }
+
+private:
+    using key_t = std::vector<uint32_t>; // Sorted cell sizes
+
+    // "SUNT", version, count, then per table: dims, cell sizes, lines.
+    // Native byte order, a foreign one fails the version check.
+    static constexpr char s_magic[4] = { 'S', 'U', 'N', 'T' };
+    static constexpr uint32_t s_version = 1;
+
+    bool load() {
+        std::ifstream file(m_path, std::ios::binary);
+        if (!file) {
+            return true; // Created on the first save
+        }
+        char magic[4] = {};
+        uint32_t version = 0;
+        uint32_t count = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!file || std::memcmp(magic, s_magic, sizeof(magic)) != 0 || version != s_version) {
+            return false;
+        }
+        std::map<key_t, std::unique_ptr<table_t>> tables;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t dims = 0;
+            file.read(reinterpret_cast<char*>(&dims), sizeof(dims));
+            if (!file || dims == 0 || dims > calibration::g_solverDims) {
+                return false;
+            }
+            key_t key(dims);
+            file.read(reinterpret_cast<char*>(key.data()), dims * sizeof(uint32_t));
+            auto table = std::make_unique<table_t>();
+            file.read(reinterpret_cast<char*>(table->lines), sizeof(table->lines));
+            if (!file) {
+                return false;
+            }
+            tables.emplace(std::move(key), std::move(table));
+        }
+        // Tables already handed out stay in place.
+        for (auto& entry : tables) {
+            m_tables.emplace(entry.first, std::move(entry.second));
+        }
+        return true;
+    }
+    // Written to a temporary file first, so a crash does not leave half a cache.
+    void save() const {
+        const std::string temp = m_path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            const uint32_t count = static_cast<uint32_t>(m_tables.size());
+            file.write(s_magic, sizeof(s_magic));
+            file.write(reinterpret_cast<const char*>(&s_version), sizeof(s_version));
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (const auto& entry : m_tables) {
+                const uint32_t dims = static_cast<uint32_t>(entry.first.size());
+                file.write(reinterpret_cast<const char*>(&dims), sizeof(dims));
+                file.write(reinterpret_cast<const char*>(entry.first.data()), dims * sizeof(uint32_t));
+                file.write(reinterpret_cast<const char*>(entry.second->lines),
+                    sizeof(entry.second->lines));
+            }
+            if (!file) {
+                std::remove(temp.c_str());
+                return;
+            }
+        }
+        std::remove(m_path.c_str());
+        std::rename(temp.c_str(), m_path.c_str());
+    }
+
+    std::mutex m_mutex;
+    std::string m_path;
+    std::map<key_t, std::unique_ptr<table_t>> m_tables;
+    std::unique_ptr<thread_pool> m_pool;
+};
+
+// A noise with the table of a table_cache instead of the built-in one.
+// noise_t: int1d, int2d, int3d or int4d.
+template <typename noise_t>
+class calibrated {
+public:
+    explicit calibrated(const noise_t& noise, table_cache& cache = table_cache::global())
+        : m_noise(noise)
+        , m_table(&cache.get(noise)) {
+    }
+
+    template <typename... coords_t>
+    uint32_t value(const coords_t... coords) const noexcept {
+        if constexpr (std::is_same_v<noise_t, int1d>) {
+            return uniform(m_table->lines, m_noise.valueRaw(coords...));
+        }
+        else {
+            return uniform(m_table->lines, m_noise.valueShifted(coords...));
+        }
+    }
+
+    const noise_t& noise() const noexcept {
+        return m_noise;
+    }
+
+private:
+    noise_t m_noise;
+    const calibration::table_t* m_table;
+};
+} // namespace noise
+
+#endif // SIMPLE_UNIFORM_NOISE_CALIBRATION
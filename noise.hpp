@@ -9,182 +9,2149 @@
 #pragma once
 #ifndef SIMPLE_UNIFORM_NOISE
 #define SIMPLE_UNIFORM_NOISE
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "staff.hpp"
 
 namespace noise {
 
+// offset(x) = intercept + (x * slope) / 2^31
+struct offset_line_t {
+    int64_t slope;
+    int64_t intercept;
+};
+
+// offset = min(intercept + (x * slope) / 2^31, x), rounded down in magnitude.
+inline uint32_t getOffsetU32(const offset_line_t& line, const uint32_t x_) noexcept {
+    const uint64_t x = x_;
+    // A negative slope subtracts the rounded-down product: (p ^ sign) - sign.
+    const uint64_t sign = static_cast<uint64_t>(line.slope >> 63);
+    const uint64_t slope = (static_cast<uint64_t>(line.slope) ^ sign) - sign;
+    const uint64_t offset = ((((x * slope) >> 31) ^ sign) - sign)
+        + static_cast<uint64_t>(line.intercept);
+    return static_cast<uint32_t>(std::min(offset, x));
+}
+
+// The table holds equal-width lines over [0, UINT32_MAX / 2] followed by
+// a zero line for everything beyond.
+template <size_t lines>
+inline uint32_t getOffsetU32(const offset_line_t (&table)[lines], const uint32_t x_) noexcept {
+    constexpr uint32_t size = (UINT32_MAX / 2) / (lines - 1) + 1;
+    return getOffsetU32(table[std::min<uint32_t>(x_ / size, lines - 1)], x_);
+}
+
+// Variable-width lines: line i covers [begin[i], begin[i + 1]). begin[0] is 0,
+// the last used line is a zero line from UINT32_MAX / 2 + 1, the unused rest
+// is padded with begin = UINT32_MAX and zero lines.
+template <size_t segments>
+struct offset_segments_t {
+    static_assert(segments >= 2 && (segments & (segments - 1)) == 0,
+        "segments must be a power of two");
+    uint32_t begin[segments];
+    offset_line_t lines[segments];
+};
+
+template <size_t segments>
+inline uint32_t getOffsetU32(const offset_segments_t<segments>& table, const uint32_t x_) noexcept {
+    // Branchless binary search over begin[]
+    size_t idx = 0;
+    for (size_t step = segments / 2; step != 0; step /= 2) {
+        idx += table.begin[idx + step] <= x_ ? step : 0;
+    }
+    return getOffsetU32(table.lines[idx], x_);
+}
+
+// Corrects the distribution of s, which is symmetric about UINT32_MAX / 2:
+// the upper half is mirrored down, corrected, and mirrored back.
+template <typename table_t>
+inline uint32_t uniform(const table_t& table, const uint32_t s) noexcept {
+    constexpr uint32_t mirror = UINT32_MAX / 2 + UINT32_MAX / 2;
+    const bool upper = s >= UINT32_MAX / 2;
+    const uint32_t folded = upper ? mirror - s : s;
+    const uint32_t corrected = folded - getOffsetU32(table, folded);
+    return upper ? mirror - corrected : corrected;
+}
+
+// Dense quantile table: knot i holds the CDF of the raw value at
+// i * 2^(32 - bits), scaled to 2^32 and saturated at UINT32_MAX. The raw
+// value is mapped through it with linear interpolation, without the fold,
+// so the accuracy depends only on bits. The knots must be non-decreasing.
+template <uint32_t bits>
+struct quantile_table_t {
+    static_assert(bits >= 1 && bits <= 20, "bits must be in [1, 20]");
+    static constexpr uint32_t knots = (1u << bits) + 1;
+    uint32_t cdf[knots];
+};
+
+template <uint32_t bits>
+inline uint32_t uniform(const quantile_table_t<bits>& table, const uint32_t s) noexcept {
+    constexpr uint32_t shift = 32 - bits;
+    const uint32_t idx = s >> shift;
+    const uint32_t a = table.cdf[idx];
+    const uint64_t width = table.cdf[idx + 1] - a;
+    const uint64_t frac = s & ((UINT64_C(1) << shift) - 1);
+    return a + static_cast<uint32_t>((width * frac) >> shift);
+}
+// out[i] = uniform(table, in[i]), a plain loop for the auto-vectorizer.
+template <uint32_t bits>
+inline void uniform(const quantile_table_t<bits>& table,
+        const uint32_t* in, uint32_t* out, const size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = uniform(table, in[i]);
+    }
+}
+
+// Writes the keys of the 2^N lattice corners of a cell: bit k of the corner
+// index selects cell[k] + cellSize[k] instead of cell[k].
+template <uint32_t N>
+inline void cornerKeys(const uint64_t (&cell)[N], const uint32_t (&cellSize)[N],
+        uint64_t (*keys)[N]) noexcept {
+    for (uint32_t corner = 0; corner < (1u << N); ++corner) {
+        for (uint32_t k = 0; k < N; ++k) {
+            keys[corner][k] = ((corner >> k) & 1) ? cell[k] + cellSize[k] : cell[k];
+        }
+    }
+}
+
+// From 3 dimensions on, mixing the shared key prefixes once beats hashing
+// the corner keys in SIMD lanes, e.g. 28 instead of 48 rounds for 3D. The
+// 2 and 4 corners of 1D and 2D are hashed one by one.
+template <uint32_t N>
+inline void hashCorners(const uint64_t (&cell)[N], const uint32_t (&cellSize)[N],
+        const uint32_t seed, uint32_t (&seeds)[1u << N]) noexcept {
+    if constexpr (N == 1) {
+        seeds[0] = utils::MurmurHash3_x32_32(cell[0], seed);
+        seeds[1] = utils::MurmurHash3_x32_32(cell[0] + cellSize[0], seed);
+    }
+    else if constexpr (N == 2) {
+        const uint64_t far_x = cell[0] + cellSize[0];
+        const uint64_t far_y = cell[1] + cellSize[1];
+        seeds[0] = utils::MurmurHash3_x32_32(cell[0], cell[1], seed);
+        seeds[1] = utils::MurmurHash3_x32_32(far_x, cell[1], seed);
+        seeds[2] = utils::MurmurHash3_x32_32(cell[0], far_y, seed);
+        seeds[3] = utils::MurmurHash3_x32_32(far_x, far_y, seed);
+    }
+    else {
+        uint64_t far[N];
+        for (uint32_t k = 0; k < N; ++k) {
+            far[k] = cell[k] + cellSize[k];
+        }
+        utils::MurmurHash3_x32_32_prefix<N>(cell, far, seed, seeds);
+    }
+}
+
+// The corner hashes of the last lattice cell, the same as hashCorners. A
+// query in the same cell hashes nothing, and a step into a face-adjacent
+// cell keeps the shared face and hashes only the other 2^(N - 1) corners.
+template <uint32_t N>
+class corner_cache {
+public:
+    static constexpr uint32_t corners = 1u << N;
+
+    const uint32_t* get(const uint64_t (&cell)[N], const uint32_t (&cellSize)[N],
+            const uint32_t seed) noexcept {
+        uint32_t moved = 0;
+        uint32_t axis = 0;
+        for (uint32_t k = 0; k < N; ++k) {
+            if (cell[k] != m_cell[k]) {
+                ++moved;
+                axis = k;
+            }
+        }
+        if (m_valid && moved == 0) {
+            return m_seeds;
+        }
+        const uint32_t bit = 1u << axis;
+        if (m_valid && moved == 1 && cell[axis] == m_cell[axis] + cellSize[axis]) {
+            // The far face becomes the near one.
+            for (uint32_t i = 0; i < corners; ++i) {
+                if ((i & bit) == 0) {
+                    m_seeds[i] = m_seeds[i | bit];
+                }
+            }
+            m_cell[axis] = cell[axis];
+            hashFace(cellSize, seed, bit, bit);
+        }
+        else if (m_valid && moved == 1 && m_cell[axis] == cell[axis] + cellSize[axis]) {
+            // The near face becomes the far one.
+            for (uint32_t i = 0; i < corners; ++i) {
+                if ((i & bit) != 0) {
+                    m_seeds[i] = m_seeds[i & ~bit];
+                }
+            }
+            m_cell[axis] = cell[axis];
+            hashFace(cellSize, seed, bit, 0);
+        }
+        else {
+            std::copy(cell, cell + N, m_cell);
+            hashCorners<N>(m_cell, cellSize, seed, m_seeds);
+            m_valid = true;
+        }
+        return m_seeds;
+    }
+
+private:
+    // Hashes the corners i with (i & bit) == side.
+    void hashFace(const uint32_t (&cellSize)[N], const uint32_t seed,
+            const uint32_t bit, const uint32_t side) noexcept {
+        uint64_t seedSrc[corners / 2][N] = {};
+        uint32_t index[corners / 2];
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < corners; ++i) {
+            if ((i & bit) == side) {
+                for (uint32_t k = 0; k < N; ++k) {
+                    seedSrc[count][k] = (i >> k) & 1 ? m_cell[k] + cellSize[k] : m_cell[k];
+                }
+                index[count++] = i;
+            }
+        }
+        uint32_t seeds[corners / 2];
+        utils::MurmurHash3_x32_32_batch<N>(seedSrc[0], corners / 2, seed, seeds);
+        for (uint32_t j = 0; j < corners / 2; ++j) {
+            m_seeds[index[j]] = seeds[j];
+        }
+    }
+
+    uint64_t m_cell[N] = {};
+    uint32_t m_seeds[corners] = {};
+    bool m_valid = false;
+};
+
+// The built-in offset tables of intNd<N>, calibrated for cellSize 64 by
+// processing/calibrate.cpp. Above 5D the solver does not converge.
+template <uint32_t N>
+struct offset_table_t;
+
+template <>
+struct offset_table_t<1> {
+    static constexpr offset_line_t s_offsetLines[128 + 1] = {
+        { INT64_C(1903768973), INT64_C(1611352) },
+        { INT64_C(1837586944), INT64_C(2170639) },
+        { INT64_C(1779989555), INT64_C(3126264) },
+        { INT64_C(1723515340), INT64_C(4504459) },
+        { INT64_C(1668143923), INT64_C(6288329) },
+        { INT64_C(1613854924), INT64_C(8461461) },
+        { INT64_C(1560628275), INT64_C(11007901) },
+        { INT64_C(1508444262), INT64_C(13912146) },
+        { INT64_C(1457283328), INT64_C(17159147) },
+        { INT64_C(1407125708), INT64_C(20734327) },
+        { INT64_C(1357952870), INT64_C(24623476) },
+        { INT64_C(1309745715), INT64_C(28812865) },
+        { INT64_C(1262485913), INT64_C(33289143) },
+        { INT64_C(1216154624), INT64_C(38039438) },
+        { INT64_C(1170734387), INT64_C(43051170) },
+        { INT64_C(1126207027), INT64_C(48312251) },
+        { INT64_C(1082554982), INT64_C(53810941) },
+        { INT64_C(1039760998), INT64_C(59535873) },
+        { INT64_C(997808076), INT64_C(65476046) },
+        { INT64_C(956679065), INT64_C(71620880) },
+        { INT64_C(916357836), INT64_C(77960038) },
+        { INT64_C(876827596), INT64_C(84483670) },
+        { INT64_C(838072422), INT64_C(91182168) },
+        { INT64_C(800076492), INT64_C(98046282) },
+        { INT64_C(762824345), INT64_C(105067062) },
+        { INT64_C(726300211), INT64_C(112235980) },
+        { INT64_C(690489753), INT64_C(119544589) },
+        { INT64_C(655377152), INT64_C(126985089) },
+        { INT64_C(620948633), INT64_C(134549602) },
+        { INT64_C(587189248), INT64_C(142230842) },
+        { INT64_C(554085376), INT64_C(150021559) },
+        { INT64_C(521622937), INT64_C(157914932) },
+        { INT64_C(489788313), INT64_C(165904358) },
+        { INT64_C(458567936), INT64_C(173983538) },
+        { INT64_C(427949158), INT64_C(182146247) },
+        { INT64_C(397918720), INT64_C(190386723) },
+        { INT64_C(368464230), INT64_C(198699269) },
+        { INT64_C(339572940), INT64_C(207078586) },
+        { INT64_C(311233228), INT64_C(215519334) },
+        { INT64_C(283433216), INT64_C(224016526) },
+        { INT64_C(256160921), INT64_C(232565482) },
+        { INT64_C(229404876), INT64_C(241161645) },
+        { INT64_C(203154585), INT64_C(249800400) },
+        { INT64_C(177398425), INT64_C(258477761) },
+        { INT64_C(152126310), INT64_C(267189486) },
+        { INT64_C(127327795), INT64_C(275931692) },
+        { INT64_C(102992486), INT64_C(284700723) },
+        { INT64_C(79110553), INT64_C(293492962) },
+        { INT64_C(55672576), INT64_C(302304868) },
+        { INT64_C(32668979), INT64_C(311133176) },
+        { INT64_C(10090496), INT64_C(319974730) },
+        { INT64_C(-12071424), INT64_C(328826302) },
+        { INT64_C(-33825587), INT64_C(337684969) },
+        { INT64_C(-55180390), INT64_C(346547845) },
+        { INT64_C(-76144025), INT64_C(355412152) },
+        { INT64_C(-96724428), INT64_C(364275198) },
+        { INT64_C(-116929126), INT64_C(373134294) },
+        { INT64_C(-136765491), INT64_C(381986860) },
+        { INT64_C(-156240947), INT64_C(390830511) },
+        { INT64_C(-175362252), INT64_C(399662731) },
+        { INT64_C(-194135910), INT64_C(408481040) },
+        { INT64_C(-212568576), INT64_C(417283185) },
+        { INT64_C(-230666240), INT64_C(426066744) },
+        { INT64_C(-248434841), INT64_C(434829413) },
+        { INT64_C(-265880166), INT64_C(443568948) },
+        { INT64_C(-283007488), INT64_C(452282979) },
+        { INT64_C(-299822182), INT64_C(460969318) },
+        { INT64_C(-316328908), INT64_C(469625521) },
+        { INT64_C(-332532531), INT64_C(478249365) },
+        { INT64_C(-348437401), INT64_C(486838465) },
+        { INT64_C(-364047667), INT64_C(495390423) },
+        { INT64_C(-379367321), INT64_C(503902857) },
+        { INT64_C(-394400000), INT64_C(512373273) },
+        { INT64_C(-409149184), INT64_C(520799176) },
+        { INT64_C(-423617945), INT64_C(529177916) },
+        { INT64_C(-437809561), INT64_C(537507034) },
+        { INT64_C(-451726182), INT64_C(545783479) },
+        { INT64_C(-465370624), INT64_C(554004649) },
+        { INT64_C(-478744985), INT64_C(562167573) },
+        { INT64_C(-491851110), INT64_C(570269171) },
+        { INT64_C(-504690944), INT64_C(578306469) },
+        { INT64_C(-517265971), INT64_C(586276248) },
+        { INT64_C(-529576960), INT64_C(594174863) },
+        { INT64_C(-541625036), INT64_C(601998920) },
+        { INT64_C(-553411072), INT64_C(609744880) },
+        { INT64_C(-564935372), INT64_C(617408856) },
+        { INT64_C(-576198348), INT64_C(624987032) },
+        { INT64_C(-587199692), INT64_C(632475117) },
+        { INT64_C(-597939251), INT64_C(639868917) },
+        { INT64_C(-608416460), INT64_C(647163949) },
+        { INT64_C(-618630656), INT64_C(654355644) },
+        { INT64_C(-628580556), INT64_C(661438983) },
+        { INT64_C(-638265036), INT64_C(668409025) },
+        { INT64_C(-647682457), INT64_C(675260430) },
+        { INT64_C(-656831180), INT64_C(681987820) },
+        { INT64_C(-665709107), INT64_C(688585437) },
+        { INT64_C(-674313984), INT64_C(695047358) },
+        { INT64_C(-682643200), INT64_C(701367334) },
+        { INT64_C(-690694041), INT64_C(707538979) },
+        { INT64_C(-698463641), INT64_C(713555721) },
+        { INT64_C(-705948416), INT64_C(719410365) },
+        { INT64_C(-713145241), INT64_C(725095989) },
+        { INT64_C(-720049817), INT64_C(730604666) },
+        { INT64_C(-726658867), INT64_C(735929187) },
+        { INT64_C(-732967168), INT64_C(741060687) },
+        { INT64_C(-738971289), INT64_C(745991649) },
+        { INT64_C(-744665548), INT64_C(750712608) },
+        { INT64_C(-750045542), INT64_C(755215037) },
+        { INT64_C(-755105792), INT64_C(759489399) },
+        { INT64_C(-759840614), INT64_C(763525852) },
+        { INT64_C(-764244684), INT64_C(767314730) },
+        { INT64_C(-768311552), INT64_C(770845263) },
+        { INT64_C(-772035328), INT64_C(774107026) },
+        { INT64_C(-775409356), INT64_C(777088774) },
+        { INT64_C(-778426931), INT64_C(779779064) },
+        { INT64_C(-781080832), INT64_C(782165831) },
+        { INT64_C(-783364198), INT64_C(784237169) },
+        { INT64_C(-785269350), INT64_C(785980261) },
+        { INT64_C(-786788659), INT64_C(787382157) },
+        { INT64_C(-787913932), INT64_C(788429205) },
+        { INT64_C(-788637030), INT64_C(789107606) },
+        { INT64_C(-788949555), INT64_C(789403132) },
+        { INT64_C(-788842905), INT64_C(789301160) },
+        { INT64_C(-788307660), INT64_C(788786079) },
+        { INT64_C(-787334860), INT64_C(787842503) },
+        { INT64_C(-785915136), INT64_C(786454436) },
+        { INT64_C(-784038502), INT64_C(784605055) },
+        { INT64_C(-782019072), INT64_C(782599926) },
+        { 0, 0 },
+    };
+};
+
+template <>
+struct offset_table_t<2> {
+    static constexpr offset_line_t s_offsetLines[128 + 1] = {
+        { INT64_C(2142268877), INT64_C(-39056) },
+        { INT64_C(2141451468), INT64_C(-1817) },
+        { INT64_C(2129167462), INT64_C(202859) },
+        { INT64_C(2115453798), INT64_C(538389) },
+        { INT64_C(2100348825), INT64_C(1025874) },
+        { INT64_C(2083890534), INT64_C(1685533) },
+        { INT64_C(2066116044), INT64_C(2536735) },
+        { INT64_C(2047062220), INT64_C(3597995) },
+        { INT64_C(2026765977), INT64_C(4886959) },
+        { INT64_C(2005262899), INT64_C(6420504) },
+        { INT64_C(1982589081), INT64_C(8214629) },
+        { INT64_C(1958778931), INT64_C(10284639) },
+        { INT64_C(1933867827), INT64_C(12644938) },
+        { INT64_C(1907889971), INT64_C(15309221) },
+        { INT64_C(1880879001), INT64_C(18290445) },
+        { INT64_C(1852868556), INT64_C(21600776) },
+        { INT64_C(1823891507), INT64_C(25251693) },
+        { INT64_C(1793980928), INT64_C(29253872) },
+        { INT64_C(1763168716), INT64_C(33617384) },
+        { INT64_C(1731486720), INT64_C(38351557) },
+        { INT64_C(1698966476), INT64_C(43465024) },
+        { INT64_C(1665638809), INT64_C(48965796) },
+        { INT64_C(1631534643), INT64_C(54861144) },
+        { INT64_C(1596684083), INT64_C(61157763) },
+        { INT64_C(1561117081), INT64_C(67861669) },
+        { INT64_C(1524863180), INT64_C(74978258) },
+        { INT64_C(1487951462), INT64_C(82512328) },
+        { INT64_C(1450410854), INT64_C(90468026) },
+        { INT64_C(1412269414), INT64_C(98849014) },
+        { INT64_C(1373555660), INT64_C(107658192) },
+        { INT64_C(1334296780), INT64_C(116898103) },
+        { INT64_C(1294520320), INT64_C(126570567) },
+        { INT64_C(1254253670), INT64_C(136676797) },
+        { INT64_C(1213522841), INT64_C(147217720) },
+        { INT64_C(1172354406), INT64_C(158193507) },
+        { INT64_C(1130774476), INT64_C(169603829) },
+        { INT64_C(1088808345), INT64_C(181447976) },
+        { INT64_C(1046481766), INT64_C(193724516) },
+        { INT64_C(1003819315), INT64_C(206431760) },
+        { INT64_C(960846080), INT64_C(219567286) },
+        { INT64_C(917585971), INT64_C(233128457) },
+        { INT64_C(874063360), INT64_C(247111925) },
+        { INT64_C(830301952), INT64_C(261513989) },
+        { INT64_C(786325043), INT64_C(276330533) },
+        { INT64_C(742155827), INT64_C(291556928) },
+        { INT64_C(697817241), INT64_C(307188093) },
+        { INT64_C(653331712), INT64_C(323218593) },
+        { INT64_C(608721817), INT64_C(339642411) },
+        { INT64_C(564009164), INT64_C(356453367) },
+        { INT64_C(519215411), INT64_C(373644755) },
+        { INT64_C(474362265), INT64_C(391209342) },
+        { INT64_C(429470976), INT64_C(409139569) },
+        { INT64_C(384562176), INT64_C(427427628) },
+        { INT64_C(339656652), INT64_C(446065167) },
+        { INT64_C(294774681), INT64_C(465043562) },
+        { INT64_C(249936742), INT64_C(484353624) },
+        { INT64_C(205162188), INT64_C(503986179) },
+        { INT64_C(160471193), INT64_C(523931234) },
+        { INT64_C(115882752), INT64_C(544178857) },
+        { INT64_C(71416217), INT64_C(564718506) },
+        { INT64_C(27090432), INT64_C(585539428) },
+        { INT64_C(-17075865), INT64_C(606630474) },
+        { INT64_C(-61064089), INT64_C(627980131) },
+        { INT64_C(-104856012), INT64_C(649576629) },
+        { INT64_C(-148433561), INT64_C(671407845) },
+        { INT64_C(-191779174), INT64_C(693461494) },
+        { INT64_C(-234874931), INT64_C(715724697) },
+        { INT64_C(-277703424), INT64_C(738184419) },
+        { INT64_C(-320247449), INT64_C(760827329) },
+        { INT64_C(-362490214), INT64_C(783639913) },
+        { INT64_C(-404414464), INT64_C(806608011) },
+        { INT64_C(-446003814), INT64_C(829717542) },
+        { INT64_C(-487241625), INT64_C(852953897) },
+        { INT64_C(-528111872), INT64_C(876302429) },
+        { INT64_C(-568598169), INT64_C(899747906) },
+        { INT64_C(-608684697), INT64_C(923275044) },
+        { INT64_C(-648355584), INT64_C(946868157) },
+        { INT64_C(-687595110), INT64_C(970511279) },
+        { INT64_C(-726388172), INT64_C(994188452) },
+        { INT64_C(-764718899), INT64_C(1017882889) },
+        { INT64_C(-802572646), INT64_C(1041578198) },
+        { INT64_C(-839934310), INT64_C(1065257356) },
+        { INT64_C(-876788633), INT64_C(1088902884) },
+        { INT64_C(-913121228), INT64_C(1112497510) },
+        { INT64_C(-948917350), INT64_C(1136023393) },
+        { INT64_C(-984162662), INT64_C(1159462617) },
+        { INT64_C(-1018842470), INT64_C(1182796686) },
+        { INT64_C(-1052942899), INT64_C(1206007322) },
+        { INT64_C(-1086449715), INT64_C(1229075672) },
+        { INT64_C(-1119348684), INT64_C(1251982550) },
+        { INT64_C(-1151626188), INT64_C(1274708869) },
+        { INT64_C(-1183268147), INT64_C(1297234894) },
+        { INT64_C(-1214261248), INT64_C(1319541115) },
+        { INT64_C(-1244591667), INT64_C(1341607337) },
+        { INT64_C(-1274245683), INT64_C(1363413114) },
+        { INT64_C(-1303210240), INT64_C(1384938174) },
+        { INT64_C(-1331471872), INT64_C(1406161633) },
+        { INT64_C(-1359017113), INT64_C(1427062291) },
+        { INT64_C(-1385833113), INT64_C(1447619101) },
+        { INT64_C(-1411906406), INT64_C(1467810242) },
+        { INT64_C(-1437223987), INT64_C(1487613935) },
+        { INT64_C(-1461773107), INT64_C(1507008301) },
+        { INT64_C(-1485540812), INT64_C(1525970998) },
+        { INT64_C(-1508513945), INT64_C(1544479215) },
+        { INT64_C(-1530679808), INT64_C(1562510208) },
+        { INT64_C(-1552025600), INT64_C(1580040850) },
+        { INT64_C(-1572538726), INT64_C(1597047885) },
+        { INT64_C(-1592206233), INT64_C(1613507461) },
+        { INT64_C(-1611015782), INT64_C(1629395943) },
+        { INT64_C(-1628954265), INT64_C(1644688752) },
+        { INT64_C(-1646009344), INT64_C(1659361658) },
+        { INT64_C(-1662168627), INT64_C(1673390105) },
+        { INT64_C(-1677418905), INT64_C(1686748522) },
+        { INT64_C(-1691748403), INT64_C(1699412299) },
+        { INT64_C(-1705143910), INT64_C(1711355273) },
+        { INT64_C(-1717593036), INT64_C(1722551704) },
+        { INT64_C(-1729083340), INT64_C(1732975518) },
+        { INT64_C(-1739602227), INT64_C(1742600209) },
+        { INT64_C(-1749137254), INT64_C(1751399116) },
+        { INT64_C(-1757675571), INT64_C(1759344906) },
+        { INT64_C(-1765204684), INT64_C(1766410283) },
+        { INT64_C(-1771711897), INT64_C(1772567461) },
+        { INT64_C(-1777184716), INT64_C(1777788553) },
+        { INT64_C(-1781610342), INT64_C(1782045084) },
+        { INT64_C(-1784976230), INT64_C(1785308528) },
+        { INT64_C(-1787269324), INT64_C(1787549565) },
+        { INT64_C(-1788477337), INT64_C(1788739322) },
+        { INT64_C(-1788645888), INT64_C(1788906289) },
+        { 0, 0 },
+    };
+};
+
+template <>
+struct offset_table_t<3> {
+    static constexpr offset_line_t s_offsetLines[128 + 1] = {
+        { INT64_C(2121864090), INT64_C(-196487) },
+        { INT64_C(2167263078), INT64_C(-448241) },
+        { INT64_C(2162528256), INT64_C(-369701) },
+        { INT64_C(2157885184), INT64_C(-256373) },
+        { INT64_C(2153261209), INT64_C(-107350) },
+        { INT64_C(2148585216), INT64_C(79915) },
+        { INT64_C(2143788646), INT64_C(309518) },
+        { INT64_C(2138805094), INT64_C(587035) },
+        { INT64_C(2133569996), INT64_C(919487) },
+        { INT64_C(2128021452), INT64_C(1315214) },
+        { INT64_C(2122098534), INT64_C(1783932) },
+        { INT64_C(2115744051), INT64_C(2336463) },
+        { INT64_C(2108901478), INT64_C(2984901) },
+        { INT64_C(2101517004), INT64_C(3742389) },
+        { INT64_C(2093538611), INT64_C(4623134) },
+        { INT64_C(2084916480), INT64_C(5642302) },
+        { INT64_C(2075602739), INT64_C(6815981) },
+        { INT64_C(2065551616), INT64_C(8161101) },
+        { INT64_C(2054719334), INT64_C(9695382) },
+        { INT64_C(2043064064), INT64_C(11437276) },
+        { INT64_C(2030545715), INT64_C(13405945) },
+        { INT64_C(2017126451), INT64_C(15621119) },
+        { INT64_C(2002770227), INT64_C(18103103) },
+        { INT64_C(1987443251), INT64_C(20872643) },
+        { INT64_C(1971113062), INT64_C(23951022) },
+        { INT64_C(1953749504), INT64_C(27359835) },
+        { INT64_C(1935324262), INT64_C(31121008) },
+        { INT64_C(1915811072), INT64_C(35256692) },
+        { INT64_C(1895185049), INT64_C(39789354) },
+        { INT64_C(1873423769), INT64_C(44741484) },
+        { INT64_C(1850506291), INT64_C(50135746) },
+        { INT64_C(1826413158), INT64_C(55994937) },
+        { INT64_C(1801127577), INT64_C(62341640) },
+        { INT64_C(1774633830), INT64_C(69198555) },
+        { INT64_C(1746918246), INT64_C(76588204) },
+        { INT64_C(1717969305), INT64_C(84532836) },
+        { INT64_C(1687776460), INT64_C(93054699) },
+        { INT64_C(1656331673), INT64_C(102175559) },
+        { INT64_C(1623628032), INT64_C(111917036) },
+        { INT64_C(1589660723), INT64_C(122300271) },
+        { INT64_C(1554426624), INT64_C(133345986) },
+        { INT64_C(1517924403), INT64_C(145074401) },
+        { INT64_C(1480154009), INT64_C(157505345) },
+        { INT64_C(1441117081), INT64_C(170658083) },
+        { INT64_C(1400817715), INT64_C(184550991) },
+        { INT64_C(1359260569), INT64_C(199202151) },
+        { INT64_C(1316452864), INT64_C(214628614) },
+        { INT64_C(1272402790), INT64_C(230846901) },
+        { INT64_C(1227120281), INT64_C(247872692) },
+        { INT64_C(1180617164), INT64_C(265720703) },
+        { INT64_C(1132906752), INT64_C(284404791) },
+        { INT64_C(1084003584), INT64_C(303938011) },
+        { INT64_C(1033924147), INT64_C(324332287) },
+        { INT64_C(982686361), INT64_C(345598558) },
+        { INT64_C(930309580), INT64_C(367746740) },
+        { INT64_C(876814438), INT64_C(390785742) },
+        { INT64_C(822223718), INT64_C(414723050) },
+        { INT64_C(766561587), INT64_C(439564994) },
+        { INT64_C(709852928), INT64_C(465317014) },
+        { INT64_C(652124979), INT64_C(491982881) },
+        { INT64_C(593405747), INT64_C(519565365) },
+        { INT64_C(533725440), INT64_C(548065528) },
+        { INT64_C(473114931), INT64_C(577483401) },
+        { INT64_C(411606784), INT64_C(607817461) },
+        { INT64_C(349235200), INT64_C(639064597) },
+        { INT64_C(286035609), INT64_C(671220272) },
+        { INT64_C(222044723), INT64_C(704278460) },
+        { INT64_C(157300531), INT64_C(738231600) },
+        { INT64_C(91842611), INT64_C(773070399) },
+        { INT64_C(25711923), INT64_C(808783888) },
+        { INT64_C(-41049548), INT64_C(845359577) },
+        { INT64_C(-108398131), INT64_C(882783054) },
+        { INT64_C(-176289280), INT64_C(921038392) },
+        { INT64_C(-244676864), INT64_C(960107713) },
+        { INT64_C(-313513676), INT64_C(999971437) },
+        { INT64_C(-382750822), INT64_C(1040607884) },
+        { INT64_C(-452338790), INT64_C(1081993863) },
+        { INT64_C(-522226483), INT64_C(1124104067) },
+        { INT64_C(-592361728), INT64_C(1166911336) },
+        { INT64_C(-662690508), INT64_C(1210386147) },
+        { INT64_C(-733158860), INT64_C(1254497740) },
+        { INT64_C(-803710412), INT64_C(1299212571) },
+        { INT64_C(-874288384), INT64_C(1344495506) },
+        { INT64_C(-944834406), INT64_C(1390309053) },
+        { INT64_C(-1015289344), INT64_C(1436613848) },
+        { INT64_C(-1085592524), INT64_C(1483368116) },
+        { INT64_C(-1155682662), INT64_C(1530528249) },
+        { INT64_C(-1225496780), INT64_C(1578048052) },
+        { INT64_C(-1294971187), INT64_C(1625879361) },
+        { INT64_C(-1364041472), INT64_C(1673972020) },
+        { INT64_C(-1432640972), INT64_C(1722272778) },
+        { INT64_C(-1500703129), INT64_C(1770726892) },
+        { INT64_C(-1568160102), INT64_C(1819277139) },
+        { INT64_C(-1634942464), INT64_C(1867863553) },
+        { INT64_C(-1700980377), INT64_C(1916424236) },
+        { INT64_C(-1766202675), INT64_C(1964894667) },
+        { INT64_C(-1830537523), INT64_C(2013208156) },
+        { INT64_C(-1893911859), INT64_C(2061295397) },
+        { INT64_C(-1956251750), INT64_C(2109084707) },
+        { INT64_C(-2017481830), INT64_C(2156501554) },
+        { INT64_C(-2077526886), INT64_C(2203469764) },
+        { INT64_C(-2136309811), INT64_C(2249909903) },
+        { INT64_C(-2193752780), INT64_C(2295740159) },
+        { INT64_C(-2249777715), INT64_C(2340876688) },
+        { INT64_C(-2304304640), INT64_C(2385232275) },
+        { INT64_C(-2357253171), INT64_C(2428717494) },
+        { INT64_C(-2408542771), INT64_C(2471240910) },
+        { INT64_C(-2458090547), INT64_C(2512707227) },
+        { INT64_C(-2505814220), INT64_C(2553019725) },
+        { INT64_C(-2551629875), INT64_C(2592078361) },
+        { INT64_C(-2595452825), INT64_C(2629780462) },
+        { INT64_C(-2637198233), INT64_C(2666021238) },
+        { INT64_C(-2676779622), INT64_C(2700692475) },
+        { INT64_C(-2714110208), INT64_C(2733683662) },
+        { INT64_C(-2749102540), INT64_C(2764881660) },
+        { INT64_C(-2781668147), INT64_C(2794170358) },
+        { INT64_C(-2811717939), INT64_C(2821431014) },
+        { INT64_C(-2839162368), INT64_C(2846542380) },
+        { INT64_C(-2863910553), INT64_C(2869379876) },
+        { INT64_C(-2885871616), INT64_C(2889816795) },
+        { INT64_C(-2904953548), INT64_C(2907723242) },
+        { INT64_C(-2921063833), INT64_C(2922966681) },
+        { INT64_C(-2934109286), INT64_C(2935411772) },
+        { INT64_C(-2943996364), INT64_C(2944920647) },
+        { INT64_C(-2950630195), INT64_C(2951351957) },
+        { INT64_C(-2953916057), INT64_C(2954562275) },
+        { INT64_C(-2953757900), INT64_C(2954404645) },
+        { INT64_C(-2950758656), INT64_C(2951425655) },
+        { 0, 0 },
+    };
+};
+
+template <>
+struct offset_table_t<4> {
+    static constexpr offset_line_t s_offsetLines[128 + 1] = {
+        { INT64_C(2105697178), INT64_C(-210912) },
+        { INT64_C(2159517900), INT64_C(-525571) },
+        { INT64_C(2158996787), INT64_C(-516753) },
+        { INT64_C(2158173388), INT64_C(-496506) },
+        { INT64_C(2157087692), INT64_C(-461392) },
+        { INT64_C(2155775232), INT64_C(-408733) },
+        { INT64_C(2154265241), INT64_C(-336384) },
+        { INT64_C(2152582963), INT64_C(-242659) },
+        { INT64_C(2150748416), INT64_C(-126134) },
+        { INT64_C(2148776550), INT64_C(14504) },
+        { INT64_C(2146678220), INT64_C(180548) },
+        { INT64_C(2144459980), INT64_C(373405) },
+        { INT64_C(2142123468), INT64_C(594795) },
+        { INT64_C(2139666534), INT64_C(846790) },
+        { INT64_C(2137083494), INT64_C(1131899) },
+        { INT64_C(2134363750), INT64_C(1453348) },
+        { INT64_C(2131494400), INT64_C(1814899) },
+        { INT64_C(2128457625), INT64_C(2221277) },
+        { INT64_C(2125233100), INT64_C(2677976) },
+        { INT64_C(2121797120), INT64_C(3191475) },
+        { INT64_C(2118122547), INT64_C(3769345) },
+        { INT64_C(2114179686), INT64_C(4420218) },
+        { INT64_C(2109935974), INT64_C(5153913) },
+        { INT64_C(2105355673), INT64_C(5981590) },
+        { INT64_C(2100401152), INT64_C(6915602) },
+        { INT64_C(2095032268), INT64_C(7969678) },
+        { INT64_C(2089206476), INT64_C(9158977) },
+        { INT64_C(2082879283), INT64_C(10500067) },
+        { INT64_C(2076004249), INT64_C(12010987) },
+        { INT64_C(2068533196), INT64_C(13711262) },
+        { INT64_C(2060416409), INT64_C(15621905) },
+        { INT64_C(2051602329), INT64_C(17765544) },
+        { INT64_C(2042038579), INT64_C(20166219) },
+        { INT64_C(2031671040), INT64_C(22849650) },
+        { INT64_C(2020444876), INT64_C(25843018) },
+        { INT64_C(2008304588), INT64_C(29174967) },
+        { INT64_C(1995193446), INT64_C(32875791) },
+        { INT64_C(1981054003), INT64_C(36977323) },
+        { INT64_C(1965829273), INT64_C(41512604) },
+        { INT64_C(1949460787), INT64_C(46516463) },
+        { INT64_C(1931891097), INT64_C(52024780) },
+        { INT64_C(1913061888), INT64_C(58075060) },
+        { INT64_C(1892914790), INT64_C(64706191) },
+        { INT64_C(1871392870), INT64_C(71957949) },
+        { INT64_C(1848438681), INT64_C(79871616) },
+        { INT64_C(1823995187), INT64_C(88489680) },
+        { INT64_C(1798007040), INT64_C(97855356) },
+        { INT64_C(1770418892), INT64_C(108013154) },
+        { INT64_C(1741176627), INT64_C(119008421) },
+        { INT64_C(1710227558), INT64_C(130887224) },
+        { INT64_C(1677520076), INT64_C(143696439) },
+        { INT64_C(1643004211), INT64_C(157483500) },
+        { INT64_C(1606631116), INT64_C(172296555) },
+        { INT64_C(1568354457), INT64_C(188183851) },
+        { INT64_C(1528129126), INT64_C(205194206) },
+        { INT64_C(1485912524), INT64_C(223376410) },
+        { INT64_C(1441663897), INT64_C(242779447) },
+        { INT64_C(1395344998), INT64_C(263452136) },
+        { INT64_C(1346919987), INT64_C(285443097) },
+        { INT64_C(1296355891), INT64_C(308800469) },
+        { INT64_C(1243622195), INT64_C(333572006) },
+        { INT64_C(1188691660), INT64_C(359804614) },
+        { INT64_C(1131539660), INT64_C(387544572) },
+        { INT64_C(1072145356), INT64_C(416836863) },
+        { INT64_C(1010490828), INT64_C(447725500) },
+        { INT64_C(946561689), INT64_C(480253116) },
+        { INT64_C(880347648), INT64_C(514460567) },
+        { INT64_C(811841689), INT64_C(550387231) },
+        { INT64_C(741041152), INT64_C(588070335) },
+        { INT64_C(667947366), INT64_C(627545010) },
+        { INT64_C(592565555), INT64_C(668844223) },
+        { INT64_C(514905856), INT64_C(711998091) },
+        { INT64_C(434982860), INT64_C(757033982) },
+        { INT64_C(352815616), INT64_C(803976375) },
+        { INT64_C(268428083), INT64_C(852846459) },
+        { INT64_C(181849446), INT64_C(903661793) },
+        { INT64_C(93113651), INT64_C(956436424) },
+        { INT64_C(2260172), INT64_C(1011180268) },
+        { INT64_C(-90666035), INT64_C(1067898976) },
+        { INT64_C(-185614694), INT64_C(1126593848) },
+        { INT64_C(-282529433), INT64_C(1187261195) },
+        { INT64_C(-381348659), INT64_C(1249892698) },
+        { INT64_C(-482004070), INT64_C(1314474290) },
+        { INT64_C(-584421632), INT64_C(1380986579) },
+        { INT64_C(-688520499), INT64_C(1449403960) },
+        { INT64_C(-794214041), INT64_C(1519695090) },
+        { INT64_C(-901408563), INT64_C(1591821836) },
+        { INT64_C(-1010003814), INT64_C(1665739412) },
+        { INT64_C(-1119892582), INT64_C(1741395888) },
+        { INT64_C(-1230960486), INT64_C(1818731828) },
+        { INT64_C(-1343086387), INT64_C(1897680359) },
+        { INT64_C(-1456141209), INT64_C(1978166119) },
+        { INT64_C(-1569988812), INT64_C(2060105633) },
+        { INT64_C(-1684485427), INT64_C(2143406687) },
+        { INT64_C(-1799478732), INT64_C(2227967409) },
+        { INT64_C(-1914810060), INT64_C(2313677637) },
+        { INT64_C(-2030311116), INT64_C(2400416266) },
+        { INT64_C(-2145805875), INT64_C(2488052376) },
+        { INT64_C(-2261110528), INT64_C(2576444956) },
+        { INT64_C(-2376032102), INT64_C(2665441593) },
+        { INT64_C(-2490368972), INT64_C(2754878577) },
+        { INT64_C(-2603911065), INT64_C(2844580803) },
+        { INT64_C(-2716439040), INT64_C(2934360846) },
+        { INT64_C(-2827724646), INT64_C(3024018963) },
+        { INT64_C(-2937530368), INT64_C(3113342523) },
+        { INT64_C(-3045608857), INT64_C(3202105254) },
+        { INT64_C(-3151704166), INT64_C(3290067955) },
+        { INT64_C(-3255549900), INT64_C(3376976687) },
+        { INT64_C(-3356869683), INT64_C(3462562832) },
+        { INT64_C(-3455377715), INT64_C(3546543261) },
+        { INT64_C(-3550778009), INT64_C(3628619382) },
+        { INT64_C(-3642763724), INT64_C(3708476244) },
+        { INT64_C(-3731018342), INT64_C(3785783224) },
+        { INT64_C(-3815214182), INT64_C(3860192421) },
+        { INT64_C(-3895013222), INT64_C(3931339027) },
+        { INT64_C(-3970066124), INT64_C(3998840138) },
+        { INT64_C(-4040013312), INT64_C(4062295372) },
+        { INT64_C(-4104483430), INT64_C(4121285143) },
+        { INT64_C(-4163093708), INT64_C(4175370627) },
+        { INT64_C(-4215450163), INT64_C(4224093589) },
+        { INT64_C(-4261147392), INT64_C(4266975846) },
+        { INT64_C(-4299768268), INT64_C(4303518622) },
+        { INT64_C(-4330883072), INT64_C(4333201345) },
+        { INT64_C(-4354050969), INT64_C(4355482682) },
+        { INT64_C(-4368818022), INT64_C(4369798260) },
+        { INT64_C(-4374718822), INT64_C(4375561855) },
+        { INT64_C(-4371275059), INT64_C(4372163621) },
+        { INT64_C(-4360323072), INT64_C(4361286635) },
+        { 0, 0 },
+    };
+};
+
+template <>
+struct offset_table_t<5> {
+    static constexpr offset_line_t s_offsetLines[128 + 1] = {
+        { INT64_C(1843069067), INT64_C(6113294) },
+        { INT64_C(1910632806), INT64_C(5547048) },
+        { INT64_C(1962825881), INT64_C(4684149) },
+        { INT64_C(2008297574), INT64_C(3577306) },
+        { INT64_C(2047584307), INT64_C(2314268) },
+        { INT64_C(2081196800), INT64_C(971237) },
+        { INT64_C(2109620992), INT64_C(-386364) },
+        { INT64_C(2133318912), INT64_C(-1703177) },
+        { INT64_C(2152728268), INT64_C(-2933126) },
+        { INT64_C(2168263424), INT64_C(-4038728) },
+        { INT64_C(2180316006), INT64_C(-4990417) },
+        { INT64_C(2189255321), INT64_C(-5765864) },
+        { INT64_C(2195428300), INT64_C(-6349277) },
+        { INT64_C(2199160524), INT64_C(-6730805) },
+        { INT64_C(2200756992), INT64_C(-6905957) },
+        { INT64_C(2200501504), INT64_C(-6874887) },
+        { INT64_C(2198658457), INT64_C(-6641957) },
+        { INT64_C(2195472332), INT64_C(-6215059) },
+        { INT64_C(2191168512), INT64_C(-5605112) },
+        { INT64_C(2185953587), INT64_C(-4825512) },
+        { INT64_C(2180016588), INT64_C(-3891733) },
+        { INT64_C(2173528371), INT64_C(-2820682) },
+        { INT64_C(2166642688), INT64_C(-1630313) },
+        { INT64_C(2159496806), INT64_C(-339208) },
+        { INT64_C(2152211558), INT64_C(1033932) },
+        { INT64_C(2144891801), INT64_C(2470712) },
+        { INT64_C(2137627545), INT64_C(3953310) },
+        { INT64_C(2130494054), INT64_C(5464913) },
+        { INT64_C(2123551948), INT64_C(6990167) },
+        { INT64_C(2116847769), INT64_C(8515498) },
+        { INT64_C(2110415462), INT64_C(10029205) },
+        { INT64_C(2104275353), INT64_C(11522106) },
+        { INT64_C(2098435635), INT64_C(12987583) },
+        { INT64_C(2092892620), INT64_C(14421905) },
+        { INT64_C(2087631155), INT64_C(15824481) },
+        { INT64_C(2082624870), INT64_C(17198153) },
+        { INT64_C(2077837158), INT64_C(18549272) },
+        { INT64_C(2073221376), INT64_C(19887955) },
+        { INT64_C(2068721203), INT64_C(21228295) },
+        { INT64_C(2064271104), INT64_C(22588522) },
+        { INT64_C(2059797196), INT64_C(23991020) },
+        { INT64_C(2055217561), INT64_C(25462482) },
+        { INT64_C(2050441984), INT64_C(27034256) },
+        { INT64_C(2045374105), INT64_C(28741872) },
+        { INT64_C(2039910092), INT64_C(30625693) },
+        { INT64_C(2033940070), INT64_C(32730647) },
+        { INT64_C(2027348633), INT64_C(35106230) },
+        { INT64_C(2020014694), INT64_C(37806735) },
+        { INT64_C(2011813068), INT64_C(40890833) },
+        { INT64_C(2002613555), INT64_C(44422051) },
+        { INT64_C(1992282726), INT64_C(48468234) },
+        { INT64_C(1980683110), INT64_C(53101969) },
+        { INT64_C(1967674828), INT64_C(58400045) },
+        { INT64_C(1953115801), INT64_C(64443442) },
+        { INT64_C(1936861593), INT64_C(71317466) },
+        { INT64_C(1918766489), INT64_C(79111358) },
+        { INT64_C(1898683750), INT64_C(87918225) },
+        { INT64_C(1876466278), INT64_C(97834772) },
+        { INT64_C(1851966924), INT64_C(108961175) },
+        { INT64_C(1825038796), INT64_C(121400938) },
+        { INT64_C(1795536281), INT64_C(135260411) },
+        { INT64_C(1763315200), INT64_C(150648667) },
+        { INT64_C(1728232755), INT64_C(167677489) },
+        { INT64_C(1690148710), INT64_C(186460745) },
+        { INT64_C(1648926361), INT64_C(207113820) },
+        { INT64_C(1604431462), INT64_C(229754050) },
+        { INT64_C(1556533913), INT64_C(254499776) },
+        { INT64_C(1505107865), INT64_C(281470159) },
+        { INT64_C(1450032435), INT64_C(310784668) },
+        { INT64_C(1391191808), INT64_C(342562866) },
+        { INT64_C(1328475596), INT64_C(376924054) },
+        { INT64_C(1261780121), INT64_C(413986398) },
+        { INT64_C(1191007846), INT64_C(453867030) },
+        { INT64_C(1116068864), INT64_C(496681010) },
+        { INT64_C(1036880691), INT64_C(542541203) },
+        { INT64_C(953368883), INT64_C(591557692) },
+        { INT64_C(865467596), INT64_C(643837188) },
+        { INT64_C(773120102), INT64_C(699482453) },
+        { INT64_C(676278988), INT64_C(758591893) },
+        { INT64_C(574907187), INT64_C(821258628) },
+        { INT64_C(468977971), INT64_C(887570177) },
+        { INT64_C(358475571), INT64_C(957607736) },
+        { INT64_C(243395532), INT64_C(1031445614) },
+        { INT64_C(123745382), INT64_C(1109150442) },
+        { INT64_C(-454963), INT64_C(1190780534) },
+        { INT64_C(-129172531), INT64_C(1276385049) },
+        { INT64_C(-262361088), INT64_C(1366003455) },
+        { INT64_C(-399960934), INT64_C(1459664969) },
+        { INT64_C(-541897574), INT64_C(1557387221) },
+        { INT64_C(-688082022), INT64_C(1659176005) },
+        { INT64_C(-838409881), INT64_C(1765024182) },
+        { INT64_C(-992761088), INT64_C(1874911006) },
+        { INT64_C(-1150999296), INT64_C(1988801203) },
+        { INT64_C(-1312971827), INT64_C(2106644419) },
+        { INT64_C(-1478508288), INT64_C(2228373695) },
+        { INT64_C(-1647421132), INT64_C(2353905331) },
+        { INT64_C(-1819504486), INT64_C(2483137465) },
+        { INT64_C(-1994533888), INT64_C(2615949312) },
+        { INT64_C(-2172265369), INT64_C(2752199863) },
+        { INT64_C(-2352436531), INT64_C(2891728124) },
+        { INT64_C(-2534763878), INT64_C(3034350447) },
+        { INT64_C(-2718944000), INT64_C(3179860806) },
+        { INT64_C(-2904651878), INT64_C(3328028824) },
+        { INT64_C(-3091542016), INT64_C(3478600005) },
+        { INT64_C(-3279246131), INT64_C(3631293223) },
+        { INT64_C(-3467373875), INT64_C(3785800594) },
+        { INT64_C(-3655511910), INT64_C(3941786028) },
+        { INT64_C(-3843223859), INT64_C(4098884463) },
+        { INT64_C(-4030048921), INT64_C(4256699978) },
+        { INT64_C(-4215502643), INT64_C(4414805689) },
+        { INT64_C(-4399075071), INT64_C(4572741416) },
+        { INT64_C(-4580231424), INT64_C(4730013471) },
+        { INT64_C(-4758411161), INT64_C(4886093071) },
+        { INT64_C(-4933027481), INT64_C(5040415083) },
+        { INT64_C(-5103466649), INT64_C(5192376609) },
+        { INT64_C(-5269088051), INT64_C(5341336189) },
+        { INT64_C(-5429223321), INT64_C(5486612171) },
+        { INT64_C(-5583175782), INT64_C(5627481334) },
+        { INT64_C(-5730220492), INT64_C(5763178042) },
+        { INT64_C(-5869603174), INT64_C(5892892368) },
+        { INT64_C(-6000540006), INT64_C(6015768980) },
+        { INT64_C(-6122217011), INT64_C(6130905639) },
+        { INT64_C(-6233789952), INT64_C(6237352154) },
+        { INT64_C(-6334383462), INT64_C(6334108608) },
+        { INT64_C(-6423090636), INT64_C(6420123979) },
+        { INT64_C(-6498972928), INT64_C(6494295061) },
+        { INT64_C(-6561058918), INT64_C(6555464262) },
+        { INT64_C(-5847809704), INT64_C(5847809703) },
+        { 0, 0 },
+    };
+};
+
+// The valueShifted offsets along one axis, precomputed for the coordinates
+// [begin, begin + size) so that fills and repeated frames over the same
+// range skip the 1D evaluation per sample. Axis k of valueShifted uses
+// the seed axisSeed(k); the offset of axis k shifts axis k - 1.
+class shift_field {
+public:
+    static constexpr uint32_t axisSeed(const uint32_t axis) noexcept {
+        return 12 + 22 * axis;
+    }
+    // The offset for the 1D value v of an axis, [0, cellSize / 2].
+    static constexpr uint32_t offset(const uint32_t cellSize, const uint32_t v) noexcept {
+        return utils::lerp_u32(v, UINT32_MAX, cellSize / 2);
+    }
+
+    shift_field() = default;
+    shift_field(uint32_t cellSize, uint32_t seed, uint64_t begin, uint32_t size);
+
+    uint64_t begin() const noexcept {
+        return m_begin;
+    }
+    uint32_t size() const noexcept {
+        return static_cast<uint32_t>(m_offsets.size());
+    }
+    uint32_t minOffset() const noexcept {
+        return m_minOffset;
+    }
+    uint32_t maxOffset() const noexcept {
+        return m_maxOffset;
+    }
+    // c in [begin, begin + size)
+    uint32_t operator[](const uint64_t c) const noexcept {
+        return m_offsets[static_cast<size_t>(c - m_begin)];
+    }
+
+private:
+    uint64_t m_begin = 0;
+    std::vector<uint32_t> m_offsets;
+    uint32_t m_minOffset = 0;
+    uint32_t m_maxOffset = 0;
+};
+
+namespace detail {
+
+// f(k) for the axes k = 0..N - 1, unrolled with k a compile-time constant so
+// that fixed cell sizes fold into the divisions.
+template <uint32_t N, typename f_t>
+inline void forAxes(f_t&& f) {
+    [&]<uint32_t... k>(std::integer_sequence<uint32_t, k...>) {
+        (f(std::integral_constant<uint32_t, k>()), ...);
+    }(std::make_integer_sequence<uint32_t, N>());
+}
+
+// N integer coordinates, optionally followed by the shifts.
+template <uint32_t N, typename... args_t>
+concept coordinates = (sizeof...(args_t) == N || sizeof...(args_t) == N + 1)
+    && (0 + ... + (std::is_integral_v<args_t> ? 1 : 0)) == N;
+
+// f(p) for the arguments (x, y, ...), f(p, fields) for (x, y, ..., fields).
+template <uint32_t N, typename f_t, typename... args_t>
+inline uint32_t unpack(f_t&& f, const args_t&... args) {
+    const std::tuple<const args_t&...> tuple(args...);
+    return [&]<size_t... k>(std::index_sequence<k...>) {
+        const uint64_t p[N] = { static_cast<uint64_t>(std::get<k>(tuple))... };
+        if constexpr (sizeof...(args_t) == N) {
+            return f(p);
+        }
+        else {
+            return f(p, std::get<N>(tuple));
+        }
+    }(std::make_index_sequence<N>());
+}
+
+// The lattice of intNd: x / cellSize[k] and the lerp over cellSize[k] - 1
+// along axis k, by hardware divisions.
+template <uint32_t N>
+struct cells_t {
+    const uint32_t (&cellSize)[N];
+
+    uint64_t divide(const uint32_t k, const uint64_t x) const noexcept {
+        return x / cellSize[k];
+    }
+    uint32_t lerp(const uint32_t k, const uint32_t t, const uint32_t a, const uint32_t b) const noexcept {
+        return utils::lerp_u32(t, cellSize[k] - 1, a, b);
+    }
+};
+
+// The same by precomputed dividers.
+template <uint32_t N>
+class divided_cells_t {
+public:
+    explicit divided_cells_t(const uint32_t (&cellSize_)[N]) noexcept {
+        for (uint32_t k = 0; k < N; ++k) {
+            cellSize[k] = cellSize_[k];
+            m_cellSize[k].set(cellSize_[k]);
+            m_cellSizeM1[k].set(cellSize_[k] - 1);
+        }
+    }
+
+    uint64_t divide(const uint32_t k, const uint64_t x) const noexcept {
+        return m_cellSize[k].divide(x);
+    }
+    uint32_t lerp(const uint32_t k, const uint32_t t, const uint32_t a, const uint32_t b) const noexcept {
+        return utils::lerp_u32(t, m_cellSizeM1[k], a, b);
+    }
+
+    uint32_t cellSize[N];
+private:
+    utils::divider_u64 m_cellSize[N];
+    utils::divider_u64 m_cellSizeM1[N];
+};
+
+// Compile-time cell sizes, the divisions fold into constants.
+template <uint32_t... cellSize_>
+struct fixed_cells_t {
+    static constexpr uint32_t cellSize[] = { cellSize_... };
+
+    static constexpr uint64_t divide(const uint32_t k, const uint64_t x) noexcept {
+        return x / cellSize[k];
+    }
+    static constexpr uint32_t lerp(const uint32_t k, const uint32_t t,
+            const uint32_t a, const uint32_t b) noexcept {
+        return utils::lerp_u32(t, cellSize[k] - 1, a, b);
+    }
+};
+
+template <uint32_t N>
+constexpr const auto& offsetLines() noexcept {
+    static_assert(N <= 5, "no calibrated table above 5D, use valueShifted or valueRaw");
+    return offset_table_t<std::min<uint32_t>(N, 5)>::s_offsetLines;
+}
+
+// The offset of axis k at x, the shift of axis k - 1 in valueShifted.
+template <typename lattice_t>
+inline uint32_t shiftOffset(const lattice_t& cells, const uint32_t k, const uint64_t x) noexcept {
+    const uint32_t cellSize = cells.cellSize[k];
+    const uint64_t cell = cells.divide(k, x) * cellSize;
+    const uint32_t seed0 = utils::MurmurHash3_x32_32(cell, shift_field::axisSeed(k));
+    const uint32_t seed1 = utils::MurmurHash3_x32_32(cell + cellSize, shift_field::axisSeed(k));
+    return shift_field::offset(cellSize, uniform(offsetLines<1>(),
+        cells.lerp(k, static_cast<uint32_t>(x - cell), seed0, seed1)));
+}
+
+// Axis k is shifted by the offset of axis k + 1.
+template <uint32_t N, typename lattice_t>
+inline void shift(const lattice_t& cells, const uint64_t (&p)[N], uint64_t (&shifted)[N]) noexcept {
+    uint32_t offsets[N];
+    forAxes<N>([&](const uint32_t k) {
+        offsets[k] = shiftOffset(cells, k, p[k]);
+    });
+    for (uint32_t k = 0; k < N; ++k) {
+        shifted[k] = p[k] + offsets[(k + 1) % N];
+    }
+}
+// The same with the precomputed offsets of a box.
+template <uint32_t N>
+inline void shift(const shift_field (&fields)[N], const uint64_t (&p)[N], uint64_t (&shifted)[N]) noexcept {
+    for (uint32_t k = 0; k < N; ++k) {
+        shifted[k] = p[k] + fields[(k + 1) % N][p[(k + 1) % N]];
+    }
+}
+
+// The cell of p and the position in it.
+template <uint32_t N, typename lattice_t>
+inline void locate(const lattice_t& cells, const uint64_t (&p)[N],
+        uint64_t (&cell)[N], uint32_t (&t)[N]) noexcept {
+    forAxes<N>([&](const uint32_t k) {
+        cell[k] = cells.divide(k, p[k]) * cells.cellSize[k];
+        t[k] = static_cast<uint32_t>(p[k] - cell[k]);
+    });
+}
+
+// Lerps the 2^(N - first) values pairwise along the axes first, first + 1,
+// ... down to one value, in place.
+template <uint32_t N, uint32_t first = 0, typename lattice_t>
+inline uint32_t reduce(const lattice_t& cells, const uint32_t (&t)[N], uint32_t* seeds) noexcept {
+    forAxes<N>([&](auto k) {
+        if constexpr (decltype(k)::value >= first) {
+            for (uint32_t i = 0; i < ((1u << N) >> (k + 1)); ++i) {
+                seeds[i] = cells.lerp(k, t[k], seeds[2 * i], seeds[2 * i + 1]);
+            }
+        }
+    });
+    return seeds[0];
+}
+
+// Lerps the 2^N corners pairwise along x, then y, ... down to one value.
+template <uint32_t N, typename lattice_t>
+inline uint32_t interpolate(const lattice_t& cells, const uint32_t (&t)[N],
+        const uint32_t* corners) noexcept {
+    uint32_t seeds[1u << N];
+    std::copy(corners, corners + (1u << N), seeds);
+    return reduce<N>(cells, t, seeds);
+}
+
+template <uint32_t N, typename lattice_t>
+inline uint32_t valueRaw(const lattice_t& cells, const uint32_t seed, const uint64_t (&p)[N]) noexcept {
+    uint64_t cell[N];
+    uint32_t t[N];
+    locate<N>(cells, p, cell, t);
+    uint32_t seeds[1u << N];
+    hashCorners<N>(cell, cells.cellSize, seed, seeds);
+    return reduce<N>(cells, t, seeds);
+}
+
+template <uint32_t N, typename lattice_t>
+inline uint32_t valueShifted(const lattice_t& cells, const uint32_t seed, const uint64_t (&p)[N]) noexcept {
+    uint64_t shifted[N];
+    shift<N>(cells, p, shifted);
+    return valueRaw<N>(cells, seed, shifted);
+}
+
+// 1D is not shifted.
+template <uint32_t N, typename lattice_t>
+inline uint32_t value(const lattice_t& cells, const uint32_t seed, const uint64_t (&p)[N]) noexcept {
+    if constexpr (N == 1) {
+        return uniform(offsetLines<N>(), valueRaw<N>(cells, seed, p));
+    }
+    else {
+        return uniform(offsetLines<N>(), valueShifted<N>(cells, seed, p));
+    }
+}
+
+} // namespace detail
+
+// N-dimensional noise, N = 1..8, the engine of int1d..int4d. Axis k is
+// shifted by the offset noise of axis k + 1, which uses the seed
+// shift_field::axisSeed(k). The uniform value() needs a calibrated table and
+// is limited to N <= 5; valueShifted and valueRaw cover all N.
+template <uint32_t N>
+struct intNd {
+    static_assert(N >= 1 && N <= 8, "N must be 1..8");
+    static constexpr uint32_t corners = 1u << N;
+
+    uint32_t cellSize[N]; // 2..UINT32_MAX
+    uint32_t seed = 0;
+
+    intNd() noexcept {
+        std::fill(cellSize, cellSize + N, 64);
+    }
+    intNd(const uint32_t (&cellSize_)[N], const uint32_t seed_) noexcept
+            : seed(seed_) {
+        std::copy(cellSize_, cellSize_ + N, cellSize);
+    }
+
+    // The shift fields of the box [begin[k], begin[k] + size[k]).
+    struct shifts {
+        shifts() = default;
+        shifts(const uint32_t (&cellSize)[N], const uint64_t (&begin)[N], const uint32_t (&size)[N]) {
+            for (uint32_t k = 0; k < N; ++k) {
+                axes[k] = shift_field(cellSize[k], shift_field::axisSeed(k), begin[k], size[k]);
+            }
+        }
+        shift_field axes[N];
+    };
+
+    template <typename... args_t> requires detail::coordinates<N, args_t...>
+    uint32_t value(const args_t&... args) const noexcept {
+        return detail::unpack<N>([this](const auto&... a) { return value(a...); }, args...);
+    }
+    uint32_t value(const uint64_t (&p)[N]) const noexcept {
+        return detail::value<N>(cells(), seed, p);
+    }
+    // p inside the box of the shifts. 1D is not shifted and takes none.
+    uint32_t value(const uint64_t (&p)[N], const shifts& fields) const noexcept requires (N >= 2) {
+        return uniform(offsetLines(), valueShifted(p, fields));
+    }
+
+    template <typename... args_t> requires detail::coordinates<N, args_t...>
+    uint32_t valueShifted(const args_t&... args) const noexcept {
+        return detail::unpack<N>([this](const auto&... a) { return valueShifted(a...); }, args...);
+    }
+    uint32_t valueShifted(const uint64_t (&p)[N]) const noexcept {
+        return detail::valueShifted<N>(cells(), seed, p);
+    }
+    uint32_t valueShifted(const uint64_t (&p)[N], const shifts& fields) const noexcept requires (N >= 2) {
+        uint64_t shifted[N];
+        detail::shift<N>(fields.axes, p, shifted);
+        return valueRaw(shifted);
+    }
+
+    template <typename... args_t> requires detail::coordinates<N, args_t...>
+    uint32_t valueRaw(const args_t&... args) const noexcept {
+        return detail::unpack<N>([this](const auto&... a) { return valueRaw(a...); }, args...);
+    }
+    uint32_t valueRaw(const uint64_t (&p)[N]) const noexcept {
+        return detail::valueRaw<N>(cells(), seed, p);
+    }
+
+    // out[i] = value(points[i]). For N < 3 the corners of several points are
+    // hashed in one batch so that all SIMD lanes are busy.
+    void values(const uint64_t (*points)[N], const size_t count, uint32_t* out) const noexcept {
+        constexpr uint32_t block = corners >= 16 ? 1 : 16 / corners;
+        const detail::cells_t<N> lattice = cells();
+        uint64_t seedSrc[block * corners][N];
+        uint32_t seeds[block][corners];
+        uint32_t t[block][N];
+        for (size_t begin = 0; begin < count; begin += block) {
+            const uint32_t size = static_cast<uint32_t>(std::min<size_t>(block, count - begin));
+            for (uint32_t j = 0; j < size; ++j) {
+                uint64_t shifted[N];
+                if constexpr (N == 1) {
+                    shifted[0] = points[begin + j][0];
+                }
+                else {
+                    detail::shift<N>(lattice, points[begin + j], shifted);
+                }
+                uint64_t cell[N];
+                detail::locate<N>(lattice, shifted, cell, t[j]);
+                if constexpr (N >= 3) {
+                    hashCorners<N>(cell, cellSize, seed, seeds[j]);
+                }
+                else {
+                    cornerKeys<N>(cell, cellSize, seedSrc + j * corners);
+                }
+            }
+            if constexpr (N < 3) {
+                utils::MurmurHash3_x32_32_batch<N>(seedSrc[0], size * corners, seed, seeds[0]);
+            }
+            for (uint32_t j = 0; j < size; ++j) {
+                out[begin + j] = uniform(offsetLines(), detail::interpolate<N>(lattice, t[j], seeds[j]));
+            }
+        }
+    }
+
+    static constexpr const auto& offsetLines() noexcept {
+        return detail::offsetLines<N>();
+    }
+    static uint32_t getOffsetU32(const uint32_t x) noexcept {
+        return noise::getOffsetU32(offsetLines(), x);
+    }
+
+    // intNd with precomputed dividers, evaluated without hardware divisions.
+    class prepared {
+    public:
+        prepared() : prepared(intNd()) {
+        }
+        prepared(const intNd& noise) noexcept
+            : m_cells(noise.cellSize)
+            , m_seed(noise.seed) {
+        }
+
+        template <typename... args_t> requires detail::coordinates<N, args_t...>
+        uint32_t value(const args_t&... args) const noexcept {
+            return detail::unpack<N>([this](const auto&... a) { return value(a...); }, args...);
+        }
+        uint32_t value(const uint64_t (&p)[N]) const noexcept {
+            return detail::value<N>(m_cells, m_seed, p);
+        }
+        uint32_t value(const uint64_t (&p)[N], const shifts& fields) const noexcept requires (N >= 2) {
+            return uniform(offsetLines(), valueShifted(p, fields));
+        }
+
+        template <typename... args_t> requires detail::coordinates<N, args_t...>
+        uint32_t valueShifted(const args_t&... args) const noexcept {
+            return detail::unpack<N>([this](const auto&... a) { return valueShifted(a...); }, args...);
+        }
+        uint32_t valueShifted(const uint64_t (&p)[N]) const noexcept {
+            return detail::valueShifted<N>(m_cells, m_seed, p);
+        }
+        uint32_t valueShifted(const uint64_t (&p)[N], const shifts& fields) const noexcept requires (N >= 2) {
+            uint64_t shifted[N];
+            detail::shift<N>(fields.axes, p, shifted);
+            return valueRaw(shifted);
+        }
+
+        template <typename... args_t> requires detail::coordinates<N, args_t...>
+        uint32_t valueRaw(const args_t&... args) const noexcept {
+            return detail::unpack<N>([this](const auto&... a) { return valueRaw(a...); }, args...);
+        }
+        uint32_t valueRaw(const uint64_t (&p)[N]) const noexcept {
+            return detail::valueRaw<N>(m_cells, m_seed, p);
+        }
+
+    private:
+        detail::divided_cells_t<N> m_cells;
+        uint32_t m_seed;
+    };
+
+    // value(p) for queries that mostly stay near the previous one, e.g. short
+    // random walks: the corner hashes of the last cell and of the last shift
+    // cells are kept. Not const, copy one per thread.
+    class locality_t {
+    public:
+        locality_t() : locality_t(intNd()) {
+        }
+        locality_t(const intNd& noise) noexcept
+            : m_cells(noise.cellSize)
+            , m_seed(noise.seed) {
+        }
+
+        template <typename... args_t> requires detail::coordinates<N, args_t...>
+        uint32_t value(const args_t&... args) noexcept {
+            return detail::unpack<N>([this](const auto&... a) { return value(a...); }, args...);
+        }
+        uint32_t value(const uint64_t (&p)[N]) noexcept {
+            if constexpr (N == 1) {
+                return uniform(offsetLines(), valueRaw(p));
+            }
+            else {
+                return uniform(offsetLines(), valueShifted(p));
+            }
+        }
+
+        template <typename... args_t> requires detail::coordinates<N, args_t...>
+        uint32_t valueShifted(const args_t&... args) noexcept {
+            return detail::unpack<N>([this](const auto&... a) { return valueShifted(a...); }, args...);
+        }
+        uint32_t valueShifted(const uint64_t (&p)[N]) noexcept {
+            uint32_t offsets[N];
+            detail::forAxes<N>([&](const uint32_t k) {
+                offsets[k] = offset(k, p[k]);
+            });
+            uint64_t shifted[N];
+            for (uint32_t k = 0; k < N; ++k) {
+                shifted[k] = p[k] + offsets[(k + 1) % N];
+            }
+            return valueRaw(shifted);
+        }
+
+        template <typename... args_t> requires detail::coordinates<N, args_t...>
+        uint32_t valueRaw(const args_t&... args) noexcept {
+            return detail::unpack<N>([this](const auto&... a) { return valueRaw(a...); }, args...);
+        }
+        uint32_t valueRaw(const uint64_t (&p)[N]) noexcept {
+            uint64_t cell[N];
+            uint32_t t[N];
+            detail::locate<N>(m_cells, p, cell, t);
+            return detail::interpolate<N>(m_cells, t, m_corners.get(cell, m_cells.cellSize, m_seed));
+        }
+
+    private:
+        // detail::shiftOffset with the hashes of the last cell of axis k.
+        uint32_t offset(const uint32_t k, const uint64_t x) noexcept {
+            const uint32_t cellSize = m_cells.cellSize[k];
+            const uint64_t cell = m_cells.divide(k, x) * cellSize;
+            const uint32_t* seeds = m_shifts[k].get({ cell }, { cellSize }, shift_field::axisSeed(k));
+            return shift_field::offset(cellSize, uniform(detail::offsetLines<1>(),
+                m_cells.lerp(k, static_cast<uint32_t>(x - cell), seeds[0], seeds[1])));
+        }
+
+        detail::divided_cells_t<N> m_cells;
+        uint32_t m_seed;
+        corner_cache<N> m_corners;
+        corner_cache<1> m_shifts[N];
+    };
+
+    // Forward iterator over consecutive x, N = 1. The lerp is advanced with
+    // an integer step and remainder, and the hash is recomputed only when the
+    // cursor enters the next cell.
+    class cursor {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = uint32_t;
+        using difference_type = int64_t;
+        using pointer = const uint32_t*;
+        using reference = uint32_t;
+
+        cursor() = default;
+        cursor(const intNd& noise, const uint64_t x = 0) noexcept
+            : m_cellSize(noise.cellSize[0])
+            , m_seed(noise.seed) {
+            static_assert(N == 1, "cursor is one-dimensional");
+            seek(x);
+        }
+
+        void seek(const uint64_t x) noexcept {
+            m_x = x;
+            m_cell = x / m_cellSize * m_cellSize;
+            m_t = static_cast<uint32_t>(x - m_cell);
+            m_seed1 = utils::MurmurHash3_x32_32(m_cell, m_seed);
+            enterCell();
+            const uint64_t distance = m_rising ? m_seed1 - m_seed0 : m_seed0 - m_seed1;
+            const uint64_t offset = m_t * distance;
+            m_step = static_cast<uint32_t>(offset / (m_cellSize - 1));
+            m_remainder = offset % (m_cellSize - 1);
+        }
+        uint64_t position() const noexcept {
+            return m_x;
+        }
+
+        uint32_t value() const noexcept {
+            return uniform(offsetLines(), valueRaw());
+        }
+        uint32_t valueRaw() const noexcept {
+            return m_rising ? m_seed0 + m_step : m_seed0 - m_step;
+        }
+
+        uint32_t operator*() const noexcept {
+            return value();
+        }
+        cursor& operator++() noexcept {
+            if (++m_x == 0) {
+                seek(0);
+            }
+            else if (++m_t == m_cellSize) {
+                m_cell += m_cellSize;
+                m_t = 0;
+                m_step = 0;
+                m_remainder = 0;
+                enterCell();
+            }
+            else {
+                m_step += m_stepQuotient;
+                m_remainder += m_stepRemainder;
+                if (m_remainder >= m_cellSize - 1) {
+                    m_remainder -= m_cellSize - 1;
+                    ++m_step;
+                }
+            }
+            return *this;
+        }
+        cursor operator++(int) noexcept {
+            cursor prev = *this;
+            ++*this;
+            return prev;
+        }
+        bool operator==(const cursor& other) const noexcept {
+            return m_x == other.m_x;
+        }
+        bool operator!=(const cursor& other) const noexcept {
+            return m_x != other.m_x;
+        }
+
+    private:
+        // Makes the hash of m_cell the left end and hashes the right end.
+        void enterCell() noexcept {
+            m_seed0 = m_seed1;
+            m_seed1 = utils::MurmurHash3_x32_32(m_cell + m_cellSize, m_seed);
+            m_rising = m_seed0 < m_seed1;
+            const uint32_t distance = m_rising ? m_seed1 - m_seed0 : m_seed0 - m_seed1;
+            m_stepQuotient = distance / (m_cellSize - 1);
+            m_stepRemainder = distance % (m_cellSize - 1);
+        }
+
+        uint64_t m_x = 0;
+        uint64_t m_cell = 0;
+        uint32_t m_cellSize = 64;
+        uint32_t m_seed = 0;
+        uint32_t m_t = 0;
+        uint32_t m_seed0 = 0;
+        uint32_t m_seed1 = 0;
+        uint32_t m_step = 0;
+        uint64_t m_remainder = 0;
+        uint32_t m_stepQuotient = 0;
+        uint32_t m_stepRemainder = 0;
+        bool m_rising = false;
+    };
+
+    cursor at(const uint64_t x) const noexcept requires (N == 1) {
+        return cursor(*this, x);
+    }
+
+    // out[i] = value(x0 + i).
+    void generate(const uint64_t x0, const size_t count, uint32_t* out) const noexcept requires (N == 1) {
+        cursor it(*this, x0);
+        for (size_t i = 0; i < count; ++i, ++it) {
+            out[i] = it.value();
+        }
+    }
+
+    // Fills out[row * stride + col] with value(x0 + col, y0 + row), N = 2.
+    // Every lattice corner of the region is hashed only once.
+    void fill(const uint64_t x0, const uint64_t y0,
+            const uint32_t width, const uint32_t height,
+            uint32_t* out, const size_t stride) const requires (N == 2) {
+        if (width == 0 || height == 0) {
+            return;
+        }
+        const shifts fields(cellSize, { x0, y0 }, { width, height });
+        const shift_field& shift_x = fields.axes[0];
+        const shift_field& shift_y = fields.axes[1];
+
+        // The shifted coordinates are x + offset_y and y + offset_x.
+        const uint64_t spanMax_x = static_cast<uint64_t>(width - 1) + shift_y.maxOffset();
+        const uint64_t spanMax_y = static_cast<uint64_t>(height - 1) + shift_x.maxOffset();
+        if (x0 > UINT64_MAX - spanMax_x || y0 > UINT64_MAX - spanMax_y) {
+            // The region wraps around, the lattice is not contiguous.
+            for (uint32_t row = 0; row < height; ++row) {
+                for (uint32_t col = 0; col < width; ++col) {
+                    out[row * stride + col] = value({ x0 + col, y0 + row }, fields);
+                }
+            }
+            return;
+        }
+        const uint64_t cellIdxMin_x = (x0 + shift_y.minOffset()) / cellSize[0];
+        const uint64_t cellIdxMin_y = (y0 + shift_x.minOffset()) / cellSize[1];
+        const size_t cells_x = (x0 + spanMax_x) / cellSize[0] - cellIdxMin_x + 2;
+        const size_t cells_y = (y0 + spanMax_y) / cellSize[1] - cellIdxMin_y + 2;
+
+        std::vector<uint32_t> seeds(cells_x * cells_y);
+        std::vector<uint64_t> seedSrc(cells_x * 2);
+        for (size_t j = 0; j < cells_y; ++j) {
+            for (size_t i = 0; i < cells_x; ++i) {
+                seedSrc[i * 2 + 0] = (cellIdxMin_x + i) * cellSize[0];
+                seedSrc[i * 2 + 1] = (cellIdxMin_y + j) * cellSize[1];
+            }
+            utils::MurmurHash3_x32_32_batch<2>(seedSrc.data(), cells_x, seed, seeds.data() + j * cells_x);
+        }
+
+        // Per-column cell and t along y, advanced incrementally row by row.
+        std::vector<uint32_t> cells_col(width);
+        std::vector<uint32_t> t_col(width);
+        for (uint32_t col = 0; col < width; ++col) {
+            const uint64_t y = y0 + shift_x[x0 + col];
+            const uint64_t cellIdx_y = y / cellSize[1];
+            cells_col[col] = static_cast<uint32_t>(cellIdx_y - cellIdxMin_y);
+            t_col[col] = static_cast<uint32_t>(y - cellIdx_y * cellSize[1]);
+        }
+
+        for (uint32_t row = 0; row < height; ++row) {
+            const uint64_t x = x0 + shift_y[y0 + row];
+            const uint64_t cellIdx_x = x / cellSize[0];
+            size_t cell_x = cellIdx_x - cellIdxMin_x;
+            uint32_t t_x = static_cast<uint32_t>(x - cellIdx_x * cellSize[0]);
+            uint32_t* dst = out + row * stride;
+
+            for (uint32_t col = 0; col < width; ++col) {
+                const uint32_t* seeds0 = seeds.data() + cells_col[col] * cells_x + cell_x;
+                const uint32_t* seeds1 = seeds0 + cells_x;
+                const uint32_t seed0 = utils::lerp_u32(t_x, cellSize[0] - 1, seeds0[0], seeds0[1]);
+                const uint32_t seed1 = utils::lerp_u32(t_x, cellSize[0] - 1, seeds1[0], seeds1[1]);
+                dst[col] = uniform(offsetLines(), utils::lerp_u32(t_col[col], cellSize[1] - 1, seed0, seed1));
+
+                if (++t_x == cellSize[0]) {
+                    t_x = 0;
+                    ++cell_x;
+                }
+                if (++t_col[col] == cellSize[1]) {
+                    t_col[col] = 0;
+                    ++cells_col[col];
+                }
+            }
+        }
+    }
+
+    // The plane of value(x, y, rest...) at constant coordinates of the axes
+    // 2..N - 1, N >= 3. The offsets and the cells of the constant axes are
+    // computed once, and fill() hashes every lattice node of the region once
+    // instead of 2^N corners per sample. The last axis is shifted by the
+    // offset of x, so its cell still varies per column.
+    class slice_t {
+    public:
+        static constexpr uint32_t last = N - 1;
+
+        slice_t(const intNd& noise, const uint64_t (&rest)[N - 2]) noexcept
+            : m_cells(noise.cellSize)
+            , m_seed(noise.seed) {
+            static_assert(N >= 3, "slice_t is of 3 or more dimensions");
+            // y is shifted by the offset of axis 2, the middle axes by the next one.
+            m_offset_y = detail::shiftOffset(m_cells, 2, rest[0]);
+            for (uint32_t k = 2; k < last; ++k) {
+                m_p[k] = rest[k - 2] + detail::shiftOffset(m_cells, k + 1, rest[k - 1]);
+            }
+            m_p[last] = rest[last - 2];
+        }
+
+        // = value(x, y, rest...)
+        uint32_t value(const uint64_t x, const uint64_t y) const noexcept {
+            return uniform(offsetLines(), valueRaw(x, y,
+                detail::shiftOffset(m_cells, 0, x), detail::shiftOffset(m_cells, 1, y)));
+        }
+
+        // Fills out[row * stride + col] with value(x0 + col, y0 + row).
+        void fill(const uint64_t x0, const uint64_t y0,
+                const uint32_t width, const uint32_t height,
+                uint32_t* out, const size_t stride) const {
+            if (width == 0 || height == 0) {
+                return;
+            }
+            const uint32_t (&cellSize)[N] = m_cells.cellSize;
+            const shift_field shift_x(cellSize[0], shift_field::axisSeed(0), x0, width);
+            const shift_field shift_y(cellSize[1], shift_field::axisSeed(1), y0, height);
+
+            // The shifted coordinates are x + offset_y, y + offset_2 and
+            // last + offset_x, the middle axes are constant.
+            const uint64_t spanMax_x = static_cast<uint64_t>(width - 1) + shift_y.maxOffset();
+            const uint64_t spanMax_y = static_cast<uint64_t>(height - 1) + m_offset_y;
+            const uint64_t spanMax_l = shift_x.maxOffset();
+            if (x0 > UINT64_MAX - spanMax_x || y0 > UINT64_MAX - spanMax_y
+                    || m_p[last] > UINT64_MAX - spanMax_l) {
+                // The region wraps around, the lattice is not contiguous.
+                for (uint32_t row = 0; row < height; ++row) {
+                    for (uint32_t col = 0; col < width; ++col) {
+                        out[row * stride + col] = uniform(offsetLines(),
+                            valueRaw(x0 + col, y0 + row, shift_x[x0 + col], shift_y[y0 + row]));
+                    }
+                }
+                return;
+            }
+            const uint64_t y0_ = y0 + m_offset_y;
+            const uint64_t cellIdxMin_x = m_cells.divide(0, x0 + shift_y.minOffset());
+            const uint64_t cellIdxMin_y = m_cells.divide(1, y0_);
+            const uint64_t cellIdxMin_l = m_cells.divide(last, m_p[last] + shift_x.minOffset());
+            const size_t cells_x = m_cells.divide(0, x0 + spanMax_x) - cellIdxMin_x + 2;
+            const size_t cells_y = m_cells.divide(1, y0_ + height - 1) - cellIdxMin_y + 2;
+            const size_t cells_l = m_cells.divide(last, m_p[last] + spanMax_l) - cellIdxMin_l + 2;
+
+            // The cells of the middle axes, 2^(N - 3) node combinations.
+            constexpr uint32_t mids = 1u << (N - 3);
+            uint64_t cell[N] = {};
+            uint32_t t[N] = {};
+            detail::locate<N>(m_cells, m_p, cell, t);
+
+            // Node (i, j, m, l) of the lattice is seeds[((l * mids + m) * cells_y + j) * cells_x + i],
+            // bit k - 2 of m selects cell[k] + cellSize[k].
+            std::vector<uint32_t> seeds(cells_x * cells_y * mids * cells_l);
+            std::vector<uint64_t> seedSrc(cells_x * N);
+            uint32_t* dst = seeds.data();
+            for (size_t l = 0; l < cells_l; ++l) {
+                for (uint32_t m = 0; m < mids; ++m) {
+                    for (size_t j = 0; j < cells_y; ++j) {
+                        for (size_t i = 0; i < cells_x; ++i) {
+                            uint64_t* key = seedSrc.data() + i * N;
+                            key[0] = (cellIdxMin_x + i) * cellSize[0];
+                            key[1] = (cellIdxMin_y + j) * cellSize[1];
+                            for (uint32_t k = 2; k < last; ++k) {
+                                key[k] = (m >> (k - 2)) & 1 ? cell[k] + cellSize[k] : cell[k];
+                            }
+                            key[last] = (cellIdxMin_l + l) * cellSize[last];
+                        }
+                        utils::MurmurHash3_x32_32_batch<N>(seedSrc.data(), cells_x, m_seed, dst);
+                        dst += cells_x;
+                    }
+                }
+            }
+            const size_t step_y = cells_x;
+            const size_t step_m = cells_x * cells_y;
+            const size_t step_l = step_m * mids;
+            // Corners 2i and 2i + 1 of a cell are seeds[node + edges[i]] and the next node along x.
+            size_t edges[corners / 2];
+            for (uint32_t i = 0; i < corners / 2; ++i) {
+                edges[i] = (i & 1) * step_y + ((i >> 1) & (mids - 1)) * step_m + (i >> (last - 1)) * step_l;
+            }
+
+            // Per-column cell and t along the last axis, the same for every row.
+            std::vector<size_t> cells_col(width);
+            std::vector<uint32_t> t_col(width);
+            for (uint32_t col = 0; col < width; ++col) {
+                const uint64_t l = m_p[last] + shift_x[x0 + col];
+                const uint64_t cellIdx_l = m_cells.divide(last, l);
+                cells_col[col] = (cellIdx_l - cellIdxMin_l) * step_l;
+                t_col[col] = static_cast<uint32_t>(l - cellIdx_l * cellSize[last]);
+            }
+
+            for (uint32_t row = 0; row < height; ++row) {
+                const uint64_t y = y0_ + row;
+                const uint64_t cellIdx_y = m_cells.divide(1, y);
+                const size_t cell_y = (cellIdx_y - cellIdxMin_y) * step_y;
+                t[1] = static_cast<uint32_t>(y - cellIdx_y * cellSize[1]);
+                const uint64_t x = x0 + shift_y[y0 + row];
+                const uint64_t cellIdx_x = m_cells.divide(0, x);
+                size_t cell_x = cellIdx_x - cellIdxMin_x;
+                t[0] = static_cast<uint32_t>(x - cellIdx_x * cellSize[0]);
+                uint32_t* line = out + row * stride;
+
+                for (uint32_t col = 0; col < width; ++col) {
+                    const uint32_t* s = seeds.data() + cells_col[col] + cell_y + cell_x;
+                    uint32_t values[corners / 2];
+                    for (uint32_t i = 0; i < corners / 2; ++i) {
+                        values[i] = m_cells.lerp(0, t[0], s[edges[i]], s[edges[i] + 1]);
+                    }
+                    t[last] = t_col[col];
+                    line[col] = uniform(offsetLines(), detail::reduce<N, 1>(m_cells, t, values));
+
+                    if (++t[0] == cellSize[0]) {
+                        t[0] = 0;
+                        ++cell_x;
+                    }
+                }
+            }
+        }
+
+    private:
+        // The raw value at (x, y) of the plane with the offsets of x and y.
+        uint32_t valueRaw(const uint64_t x, const uint64_t y,
+                const uint32_t offset_x, const uint32_t offset_y) const noexcept {
+            uint64_t p[N];
+            std::copy(m_p, m_p + N, p);
+            p[0] = x + offset_y;
+            p[1] = y + m_offset_y;
+            p[last] += offset_x;
+            return detail::valueRaw<N>(m_cells, m_seed, p);
+        }
+
+        detail::divided_cells_t<N> m_cells;
+        uint32_t m_seed;
+        uint32_t m_offset_y = 0;
+        uint64_t m_p[N] = {}; // Shifted, the last axis is not
+    };
+
+    template <typename... rest_t> requires (sizeof...(rest_t) + 2 == N && (std::is_integral_v<rest_t> && ...))
+    slice_t slice(const rest_t... rest) const noexcept {
+        return slice_t(*this, { static_cast<uint64_t>(rest)... });
+    }
+
+    // Streams the volume [x0, x0 + width) x [y0, y0 + height) slice by slice
+    // along z, N = 3. next() fills the slice at z() and moves to z() + 1. The
+    // lattice planes along z are hashed once into a ring and reused by the
+    // following slices. The columns of a slice reach the z cells of
+    // z + [minOffset_x, maxOffset_x], so the ring holds spread / cellSize.z + 3
+    // planes, where spread = maxOffset_x - minOffset_x <= cellSize.x / 2. The
+    // count grows with cellSize.x / cellSize.z, e.g. up to 259 planes for
+    // cellSize { 1024, 1024, 2 }; a plane is the xy lattice of the region.
+    // Above s_maxPlanes the slices are evaluated per sample instead.
+    class slab_t {
+    public:
+        static constexpr size_t s_maxPlanes = 16;
+
+        slab_t(const intNd& noise, const uint64_t x0, const uint64_t y0,
+                const uint32_t width, const uint32_t height, const uint64_t z0)
+            : m_cells(noise.cellSize)
+            , m_seed(noise.seed)
+            , m_x0(x0)
+            , m_y0(y0)
+            , m_width(width)
+            , m_height(height)
+            , m_z(z0)
+            , m_shift_x(noise.cellSize[0], shift_field::axisSeed(0), x0, width)
+            , m_shift_y(noise.cellSize[1], shift_field::axisSeed(1), y0, height) {
+            static_assert(N == 3, "slab_t is three-dimensional");
+            if (width == 0 || height == 0) {
+                return;
+            }
+            // The shifted coordinates are x + offset_y, y + offset_z and z + offset_x,
+            // offset_z <= cellSize.z / 2 for any z.
+            const uint64_t spanMax_x = static_cast<uint64_t>(width - 1) + m_shift_y.maxOffset();
+            const uint64_t spanMax_y = static_cast<uint64_t>(height - 1) + noise.cellSize[2] / 2;
+            m_wraps = x0 > UINT64_MAX - spanMax_x || y0 > UINT64_MAX - spanMax_y;
+            if (m_wraps) {
+                return;
+            }
+            m_cellIdxMin_x = m_cells.divide(0, x0 + m_shift_y.minOffset());
+            m_cellIdxMin_y = m_cells.divide(1, y0);
+            m_cells_x = m_cells.divide(0, x0 + spanMax_x) - m_cellIdxMin_x + 2;
+            m_cells_y = m_cells.divide(1, y0 + spanMax_y) - m_cellIdxMin_y + 2;
+
+            // The z cells of a slice are at most spread / cellSize.z + 2, each with
+            // its next plane.
+            const size_t planes = (m_shift_x.maxOffset() - m_shift_x.minOffset()) / noise.cellSize[2] + 3;
+            m_direct = planes > s_maxPlanes;
+            if (m_direct) {
+                return;
+            }
+            m_seeds.resize(planes * m_cells_x * m_cells_y);
+            m_planeIdx.assign(planes, UINT64_MAX);
+            m_seedSrc.resize(m_cells_x * 3);
+            m_planes_col.resize(static_cast<size_t>(width) * 2);
+            m_t_col.resize(width);
+        }
+
+        uint64_t z() const noexcept {
+            return m_z;
+        }
+
+        // Fills out[row * stride + col] with value(x0 + col, y0 + row, z()).
+        void next(uint32_t* out, const size_t stride) {
+            const uint64_t z = m_z++;
+            if (m_width == 0 || m_height == 0) {
+                return;
+            }
+            const uint32_t (&cellSize)[N] = m_cells.cellSize;
+            const uint32_t offset_z = detail::shiftOffset(m_cells, 2, z);
+            if (m_direct || m_wraps || z > UINT64_MAX - m_shift_x.maxOffset()) {
+                // The planes do not fit into the ring, or the region wraps
+                // around and the lattice is not contiguous.
+                for (uint32_t row = 0; row < m_height; ++row) {
+                    for (uint32_t col = 0; col < m_width; ++col) {
+                        const uint64_t x = m_x0 + col;
+                        const uint64_t y = m_y0 + row;
+                        out[row * stride + col] = uniform(offsetLines(), detail::valueRaw<N>(m_cells, m_seed,
+                            { x + m_shift_y[y], y + offset_z, z + m_shift_x[x] }));
+                    }
+                }
+                return;
+            }
+
+            // Per-column planes and t along z. The planes of a slice must not
+            // evict each other from the ring.
+            assert(m_cells.divide(2, z + m_shift_x.maxOffset()) + 2
+                - m_cells.divide(2, z + m_shift_x.minOffset()) <= m_planeIdx.size());
+            for (uint32_t col = 0; col < m_width; ++col) {
+                const uint64_t z_ = z + m_shift_x[m_x0 + col];
+                const uint64_t cellIdx_z = m_cells.divide(2, z_);
+                m_planes_col[col * 2 + 0] = plane(cellIdx_z);
+                m_planes_col[col * 2 + 1] = plane(cellIdx_z + 1);
+                m_t_col[col] = static_cast<uint32_t>(z_ - cellIdx_z * cellSize[2]);
+            }
+
+            const size_t step_y = m_cells_x;
+            for (uint32_t row = 0; row < m_height; ++row) {
+                const uint64_t y = m_y0 + row + offset_z;
+                const uint64_t cellIdx_y = m_cells.divide(1, y);
+                const size_t cell_y = (cellIdx_y - m_cellIdxMin_y) * step_y;
+                const uint32_t t_y = static_cast<uint32_t>(y - cellIdx_y * cellSize[1]);
+                const uint64_t x = m_x0 + m_shift_y[m_y0 + row];
+                const uint64_t cellIdx_x = m_cells.divide(0, x);
+                size_t cell_x = cellIdx_x - m_cellIdxMin_x;
+                uint32_t t_x = static_cast<uint32_t>(x - cellIdx_x * cellSize[0]);
+                uint32_t* dst = out + row * stride;
+
+                for (uint32_t col = 0; col < m_width; ++col) {
+                    const uint32_t* s0 = m_planes_col[col * 2 + 0] + cell_y + cell_x;
+                    const uint32_t* s1 = m_planes_col[col * 2 + 1] + cell_y + cell_x;
+                    const uint32_t seed00 = m_cells.lerp(0, t_x, s0[0], s0[1]);
+                    const uint32_t seed01 = m_cells.lerp(0, t_x, s0[step_y], s0[step_y + 1]);
+                    const uint32_t seed10 = m_cells.lerp(0, t_x, s1[0], s1[1]);
+                    const uint32_t seed11 = m_cells.lerp(0, t_x, s1[step_y], s1[step_y + 1]);
+
+                    const uint32_t seed0 = m_cells.lerp(1, t_y, seed00, seed01);
+                    const uint32_t seed1 = m_cells.lerp(1, t_y, seed10, seed11);
+
+                    dst[col] = uniform(offsetLines(), m_cells.lerp(2, m_t_col[col], seed0, seed1));
+
+                    if (++t_x == cellSize[0]) {
+                        t_x = 0;
+                        ++cell_x;
+                    }
+                }
+            }
+        }
+
+    private:
+        // The seeds of the lattice plane cellIdx_z, hashed on the first use.
+        const uint32_t* plane(const uint64_t cellIdx_z) {
+            const size_t slot = static_cast<size_t>(cellIdx_z % m_planeIdx.size());
+            uint32_t* seeds = m_seeds.data() + slot * m_cells_x * m_cells_y;
+            if (m_planeIdx[slot] != cellIdx_z) {
+                m_planeIdx[slot] = cellIdx_z;
+                const uint32_t (&cellSize)[N] = m_cells.cellSize;
+                for (size_t j = 0; j < m_cells_y; ++j) {
+                    for (size_t i = 0; i < m_cells_x; ++i) {
+                        m_seedSrc[i * 3 + 0] = (m_cellIdxMin_x + i) * cellSize[0];
+                        m_seedSrc[i * 3 + 1] = (m_cellIdxMin_y + j) * cellSize[1];
+                        m_seedSrc[i * 3 + 2] = cellIdx_z * cellSize[2];
+                    }
+                    utils::MurmurHash3_x32_32_batch<3>(m_seedSrc.data(), m_cells_x, m_seed,
+                        seeds + j * m_cells_x);
+                }
+            }
+            return seeds;
+        }
+
+        detail::divided_cells_t<N> m_cells;
+        uint32_t m_seed;
+        uint64_t m_x0;
+        uint64_t m_y0;
+        uint32_t m_width;
+        uint32_t m_height;
+        uint64_t m_z;
+        shift_field m_shift_x;
+        shift_field m_shift_y;
+        bool m_wraps = false;
+        bool m_direct = false;
+        uint64_t m_cellIdxMin_x = 0;
+        uint64_t m_cellIdxMin_y = 0;
+        size_t m_cells_x = 0;
+        size_t m_cells_y = 0;
+        // Node (i, j) of the plane in slot k is m_seeds[(k * m_cells_y + j) * m_cells_x + i],
+        // the plane in slot k is m_planeIdx[k].
+        std::vector<uint32_t> m_seeds;
+        std::vector<uint64_t> m_planeIdx;
+        std::vector<uint64_t> m_seedSrc;
+        std::vector<const uint32_t*> m_planes_col;
+        std::vector<uint32_t> m_t_col;
+    };
+
+    slab_t slab(const uint64_t x0, const uint64_t y0,
+            const uint32_t width, const uint32_t height, const uint64_t z0) const requires (N == 3) {
+        return slab_t(*this, x0, y0, width, height, z0);
+    }
+
+    // Frames of the plane [x0, x0 + width) x [y0, y0 + height) at a constant z
+    // for a varying w, N = 4. Every pixel caches its 4 xy-interpolated lattice
+    // values at the bracketing z and w nodes; a frame lerps them by t_z and
+    // t_w. z is shifted by the offset of w and w by the offset of x, so the
+    // cache of a column is rebuilt when its w cell changes, and the whole
+    // cache when the z cell changes. The w planes are kept in a ring of
+    // spread / cellSize.w + 3 planes like in slab_t, with spread <= cellSize.x / 2,
+    // e.g. up to 259 planes for cellSize { 1024, 1024, 64, 2 }. Above
+    // s_maxPlanes the frames are evaluated per sample instead.
+    class animation_t {
+    public:
+        static constexpr size_t s_maxPlanes = 16;
+
+        animation_t(const intNd& noise, const uint64_t x0, const uint64_t y0,
+                const uint32_t width, const uint32_t height, const uint64_t z)
+            : m_cells(noise.cellSize)
+            , m_seed(noise.seed)
+            , m_x0(x0)
+            , m_y0(y0)
+            , m_width(width)
+            , m_height(height)
+            , m_z(z)
+            , m_offset_z(detail::shiftOffset(m_cells, 2, z))
+            , m_shift_x(noise.cellSize[0], shift_field::axisSeed(0), x0, width)
+            , m_shift_y(noise.cellSize[1], shift_field::axisSeed(1), y0, height) {
+            static_assert(N == 4, "animation_t is four-dimensional");
+            if (width == 0 || height == 0) {
+                return;
+            }
+            // The shifted coordinates are x + offset_y, y + offset_z, z + offset_w
+            // and w + offset_x.
+            const uint64_t spanMax_x = static_cast<uint64_t>(width - 1) + m_shift_y.maxOffset();
+            const uint64_t spanMax_y = static_cast<uint64_t>(height - 1) + m_offset_z;
+            m_wraps = x0 > UINT64_MAX - spanMax_x || y0 > UINT64_MAX - spanMax_y;
+            if (m_wraps) {
+                return;
+            }
+            const uint64_t y0_ = y0 + m_offset_z;
+            m_cellIdxMin_x = m_cells.divide(0, x0 + m_shift_y.minOffset());
+            m_cellIdxMin_y = m_cells.divide(1, y0_);
+            m_cells_x = m_cells.divide(0, x0 + spanMax_x) - m_cellIdxMin_x + 2;
+            m_cells_y = m_cells.divide(1, y0_ + height - 1) - m_cellIdxMin_y + 2;
+
+            // The w cells of a frame are at most spread / cellSize.w + 2, each with
+            // its next plane.
+            const size_t planes = (m_shift_x.maxOffset() - m_shift_x.minOffset()) / noise.cellSize[3] + 3;
+            m_direct = planes > s_maxPlanes;
+            if (m_direct) {
+                return;
+            }
+            m_seeds.resize(planes * 2 * m_cells_x * m_cells_y);
+            m_planeIdx.assign(planes, UINT64_MAX);
+            m_seedSrc.resize(m_cells_x * 4);
+            m_cache.resize(static_cast<size_t>(width) * height * 4);
+            m_cellIdx_col.assign(width, UINT64_MAX);
+            m_t_col.resize(width);
+            m_cell_row.resize(height);
+            m_t_row.resize(height);
+            m_x_row.resize(height);
+            for (uint32_t row = 0; row < height; ++row) {
+                const uint64_t y = y0_ + row;
+                const uint64_t cellIdx_y = m_cells.divide(1, y);
+                m_cell_row[row] = (cellIdx_y - m_cellIdxMin_y) * m_cells_x;
+                m_t_row[row] = static_cast<uint32_t>(y - cellIdx_y * noise.cellSize[1]);
+                m_x_row[row] = x0 + m_shift_y[y0 + row];
+            }
+        }
+
+        // Fills out[row * stride + col] with value(x0 + col, y0 + row, z, w).
+        void fill(const uint64_t w, uint32_t* out, const size_t stride) {
+            if (m_width == 0 || m_height == 0) {
+                return;
+            }
+            const uint32_t (&cellSize)[N] = m_cells.cellSize;
+            const uint64_t z = m_z + detail::shiftOffset(m_cells, 3, w);
+            if (m_direct || m_wraps || w > UINT64_MAX - m_shift_x.maxOffset()) {
+                // The planes do not fit into the ring, or the region wraps
+                // around and the lattice is not contiguous.
+                for (uint32_t row = 0; row < m_height; ++row) {
+                    for (uint32_t col = 0; col < m_width; ++col) {
+                        const uint64_t x = m_x0 + col;
+                        const uint64_t y = m_y0 + row;
+                        out[row * stride + col] = uniform(offsetLines(), detail::valueRaw<N>(m_cells, m_seed,
+                            { x + m_shift_y[y], y + m_offset_z, z, w + m_shift_x[x] }));
+                    }
+                }
+                return;
+            }
+            const uint64_t cellIdx_z = m_cells.divide(2, z);
+            const uint32_t t_z = static_cast<uint32_t>(z - cellIdx_z * cellSize[2]);
+            if (cellIdx_z != m_cellIdx_z) {
+                m_cellIdx_z = cellIdx_z;
+                std::fill(m_planeIdx.begin(), m_planeIdx.end(), UINT64_MAX);
+                std::fill(m_cellIdx_col.begin(), m_cellIdx_col.end(), UINT64_MAX);
+            }
+
+            // The columns whose w cell changed. The planes of a frame must not
+            // evict each other from the ring.
+            assert(m_cells.divide(3, w + m_shift_x.maxOffset()) + 2
+                - m_cells.divide(3, w + m_shift_x.minOffset()) <= m_planeIdx.size());
+            m_stale.clear();
+            for (uint32_t col = 0; col < m_width; ++col) {
+                const uint64_t w_ = w + m_shift_x[m_x0 + col];
+                const uint64_t cellIdx_w = m_cells.divide(3, w_);
+                m_t_col[col] = static_cast<uint32_t>(w_ - cellIdx_w * cellSize[3]);
+                if (cellIdx_w != m_cellIdx_col[col]) {
+                    m_cellIdx_col[col] = cellIdx_w;
+                    m_stale.push_back({ col, plane(cellIdx_w), plane(cellIdx_w + 1) });
+                }
+            }
+            if (!m_stale.empty()) {
+                rebuild();
+            }
+
+            for (uint32_t row = 0; row < m_height; ++row) {
+                const uint32_t* cache = m_cache.data() + static_cast<size_t>(row) * m_width * 4;
+                uint32_t* dst = out + row * stride;
+                for (uint32_t col = 0; col < m_width; ++col) {
+                    const uint32_t* c = cache + col * 4;
+                    const uint32_t seed0 = m_cells.lerp(2, t_z, c[0], c[1]);
+                    const uint32_t seed1 = m_cells.lerp(2, t_z, c[2], c[3]);
+                    dst[col] = uniform(offsetLines(), m_cells.lerp(3, m_t_col[col], seed0, seed1));
+                }
+            }
+        }
+
+    private:
+        struct column_t {
+            uint32_t col;
+            const uint32_t* plane0; // The w cell
+            const uint32_t* plane1; // The next w cell
+        };
+
+        // The seeds of the lattice plane cellIdx_w at the current z cell, hashed on
+        // the first use. Node (i, j, k) is plane[(k * m_cells_y + j) * m_cells_x + i].
+        const uint32_t* plane(const uint64_t cellIdx_w) {
+            const size_t slot = static_cast<size_t>(cellIdx_w % m_planeIdx.size());
+            uint32_t* seeds = m_seeds.data() + slot * 2 * m_cells_x * m_cells_y;
+            if (m_planeIdx[slot] != cellIdx_w) {
+                m_planeIdx[slot] = cellIdx_w;
+                const uint32_t (&cellSize)[N] = m_cells.cellSize;
+                for (size_t k = 0; k < 2; ++k) {
+                    for (size_t j = 0; j < m_cells_y; ++j) {
+                        for (size_t i = 0; i < m_cells_x; ++i) {
+                            m_seedSrc[i * 4 + 0] = (m_cellIdxMin_x + i) * cellSize[0];
+                            m_seedSrc[i * 4 + 1] = (m_cellIdxMin_y + j) * cellSize[1];
+                            m_seedSrc[i * 4 + 2] = (m_cellIdx_z + k) * cellSize[2];
+                            m_seedSrc[i * 4 + 3] = cellIdx_w * cellSize[3];
+                        }
+                        utils::MurmurHash3_x32_32_batch<4>(m_seedSrc.data(), m_cells_x, m_seed,
+                            seeds + (k * m_cells_y + j) * m_cells_x);
+                    }
+                }
+            }
+            return seeds;
+        }
+
+        // Recomputes the cache of the stale columns.
+        void rebuild() noexcept {
+            const uint32_t (&cellSize)[N] = m_cells.cellSize;
+            const size_t step_y = m_cells_x;
+            const size_t step_z = m_cells_x * m_cells_y;
+            for (uint32_t row = 0; row < m_height; ++row) {
+                const size_t cell_y = m_cell_row[row];
+                const uint32_t t_y = m_t_row[row];
+                uint32_t* cache = m_cache.data() + static_cast<size_t>(row) * m_width * 4;
+                for (const column_t& column : m_stale) {
+                    const uint64_t x = m_x_row[row] + column.col;
+                    const uint64_t cellIdx_x = m_cells.divide(0, x);
+                    const uint32_t t_x = static_cast<uint32_t>(x - cellIdx_x * cellSize[0]);
+                    const size_t cell = cell_y + static_cast<size_t>(cellIdx_x - m_cellIdxMin_x);
+                    const uint32_t* s0 = column.plane0 + cell;
+                    const uint32_t* s1 = column.plane1 + cell;
+                    const uint32_t seed000 = m_cells.lerp(0, t_x, s0[0], s0[1]);
+                    const uint32_t seed001 = m_cells.lerp(0, t_x, s0[step_y], s0[step_y + 1]);
+                    const uint32_t seed010 = m_cells.lerp(0, t_x, s0[step_z], s0[step_z + 1]);
+                    const uint32_t seed011 = m_cells.lerp(0, t_x, s0[step_z + step_y], s0[step_z + step_y + 1]);
+                    const uint32_t seed100 = m_cells.lerp(0, t_x, s1[0], s1[1]);
+                    const uint32_t seed101 = m_cells.lerp(0, t_x, s1[step_y], s1[step_y + 1]);
+                    const uint32_t seed110 = m_cells.lerp(0, t_x, s1[step_z], s1[step_z + 1]);
+                    const uint32_t seed111 = m_cells.lerp(0, t_x, s1[step_z + step_y], s1[step_z + step_y + 1]);
+
+                    uint32_t* c = cache + column.col * 4;
+                    c[0] = m_cells.lerp(1, t_y, seed000, seed001);
+                    c[1] = m_cells.lerp(1, t_y, seed010, seed011);
+                    c[2] = m_cells.lerp(1, t_y, seed100, seed101);
+                    c[3] = m_cells.lerp(1, t_y, seed110, seed111);
+                }
+            }
+        }
+
+        detail::divided_cells_t<N> m_cells;
+        uint32_t m_seed;
+        uint64_t m_x0;
+        uint64_t m_y0;
+        uint32_t m_width;
+        uint32_t m_height;
+        uint64_t m_z;
+        uint32_t m_offset_z;
+        shift_field m_shift_x;
+        shift_field m_shift_y;
+        bool m_wraps = false;
+        bool m_direct = false;
+        uint64_t m_cellIdxMin_x = 0;
+        uint64_t m_cellIdxMin_y = 0;
+        size_t m_cells_x = 0;
+        size_t m_cells_y = 0;
+        uint64_t m_cellIdx_z = UINT64_MAX; // Of the cached planes
+        // The plane in slot k is m_seeds[k * 2 * m_cells_x * m_cells_y], m_planeIdx[k] is its w cell.
+        std::vector<uint32_t> m_seeds;
+        std::vector<uint64_t> m_planeIdx;
+        std::vector<uint64_t> m_seedSrc;
+        // Pixel (col, row) is m_cache[(row * width + col) * 4], the values at the
+        // (w, z) nodes (0, 0), (0, 1), (1, 0) and (1, 1); m_cellIdx_col[col] is their w cell.
+        std::vector<uint32_t> m_cache;
+        std::vector<uint64_t> m_cellIdx_col;
+        std::vector<uint32_t> m_t_col;
+        std::vector<size_t> m_cell_row;
+        std::vector<uint32_t> m_t_row;
+        std::vector<uint64_t> m_x_row;
+        std::vector<column_t> m_stale;
+    };
+
+    animation_t animation(const uint64_t x0, const uint64_t y0,
+            const uint32_t width, const uint32_t height, const uint64_t z) const requires (N == 4) {
+        return animation_t(*this, x0, y0, width, height, z);
+    }
+
+private:
+    detail::cells_t<N> cells() const noexcept {
+        return { cellSize };
+    }
+};
+
+inline shift_field::shift_field(const uint32_t cellSize, const uint32_t seed,
+        const uint64_t begin, const uint32_t size)
+        : m_begin(begin), m_offsets(size) {
+    intNd<1>({ cellSize }, seed).generate(begin, size, m_offsets.data());
+    m_minOffset = size != 0 ? UINT32_MAX : 0;
+    for (uint32_t& offset : m_offsets) {
+        offset = shift_field::offset(cellSize, offset);
+        m_minOffset = std::min(m_minOffset, offset);
+        m_maxOffset = std::max(m_maxOffset, offset);
+    }
+}
+
+// int1d..int4d name the axes of intNd<1>..intNd<4> x, y, z and w and forward
+// to it, the shared types are those of intNd.
 struct int1d {
     uint32_t cellSize = 64; // 2..UINT32_MAX
     uint32_t seed = 0;
 
-    uint32_t value(const uint64_t x) const noexcept {
-        uint32_t s = valueRaw(x);
-        if (s < UINT32_MAX / 2) {
-            return s - getOffsetU32(s);
-        }
-        s -= UINT32_MAX / 2;
-        s = UINT32_MAX / 2 - s;
-        s -= getOffsetU32(s);
-        s = UINT32_MAX / 2 - s;
-        s += UINT32_MAX / 2;
-        return s;
+    using prepared = intNd<1>::prepared;
+    using locality_t = intNd<1>::locality_t;
+    using cursor = intNd<1>::cursor;
+
+    operator intNd<1>() const noexcept {
+        return intNd<1>({ cellSize }, seed);
     }
 
+    uint32_t value(const uint64_t x) const noexcept {
+        return intNd<1>(*this).value(x);
+    }
     uint32_t valueRaw(const uint64_t x) const noexcept {
-        const uint64_t cellIdx = x / cellSize;
-        const uint64_t cell = cellIdx * cellSize;
-        const uint64_t t = x - cell;
-
-        const uint32_t seed0 = utils::MurmurHash3_x32_32(&cell, sizeof(cell), seed);
-        const uint64_t seedSrc = cell + cellSize;
-        const uint32_t seed1 = utils::MurmurHash3_x32_32(&seedSrc, sizeof(seedSrc), seed);
-
-        return utils::lerp_u32(t, cellSize - 1, seed0, seed1);
-    }
-
-    static uint32_t getOffsetU32(const uint32_t x_) noexcept {
-        if (x_ == 0) {
-            return 0;
-        }
-        constexpr uint32_t size = (UINT32_MAX / 2) / 128 + 1;
-        const uint64_t x = x_;
-        uint64_t offset = 0;
-        switch (x_ / size) {
-        case 0: offset = (x * UINT64_C(1903768973)) / UINT64_C(2147483648) + UINT64_C(1611352); break;
-        case 1: offset = (x * UINT64_C(1837586944)) / UINT64_C(2147483648) + UINT64_C(2170639); break;
-        case 2: offset = (x * UINT64_C(1779989555)) / UINT64_C(2147483648) + UINT64_C(3126264); break;
-        case 3: offset = (x * UINT64_C(1723515340)) / UINT64_C(2147483648) + UINT64_C(4504459); break;
-        case 4: offset = (x * UINT64_C(1668143923)) / UINT64_C(2147483648) + UINT64_C(6288329); break;
-        case 5: offset = (x * UINT64_C(1613854924)) / UINT64_C(2147483648) + UINT64_C(8461461); break;
-        case 6: offset = (x * UINT64_C(1560628275)) / UINT64_C(2147483648) + UINT64_C(11007901); break;
-        case 7: offset = (x * UINT64_C(1508444262)) / UINT64_C(2147483648) + UINT64_C(13912146); break;
-        case 8: offset = (x * UINT64_C(1457283328)) / UINT64_C(2147483648) + UINT64_C(17159147); break;
-        case 9: offset = (x * UINT64_C(1407125708)) / UINT64_C(2147483648) + UINT64_C(20734327); break;
-        case 10: offset = (x * UINT64_C(1357952870)) / UINT64_C(2147483648) + UINT64_C(24623476); break;
-        case 11: offset = (x * UINT64_C(1309745715)) / UINT64_C(2147483648) + UINT64_C(28812865); break;
-        case 12: offset = (x * UINT64_C(1262485913)) / UINT64_C(2147483648) + UINT64_C(33289143); break;
-        case 13: offset = (x * UINT64_C(1216154624)) / UINT64_C(2147483648) + UINT64_C(38039438); break;
-        case 14: offset = (x * UINT64_C(1170734387)) / UINT64_C(2147483648) + UINT64_C(43051170); break;
-        case 15: offset = (x * UINT64_C(1126207027)) / UINT64_C(2147483648) + UINT64_C(48312251); break;
-        case 16: offset = (x * UINT64_C(1082554982)) / UINT64_C(2147483648) + UINT64_C(53810941); break;
-        case 17: offset = (x * UINT64_C(1039760998)) / UINT64_C(2147483648) + UINT64_C(59535873); break;
-        case 18: offset = (x * UINT64_C(997808076)) / UINT64_C(2147483648) + UINT64_C(65476046); break;
-        case 19: offset = (x * UINT64_C(956679065)) / UINT64_C(2147483648) + UINT64_C(71620880); break;
-        case 20: offset = (x * UINT64_C(916357836)) / UINT64_C(2147483648) + UINT64_C(77960038); break;
-        case 21: offset = (x * UINT64_C(876827596)) / UINT64_C(2147483648) + UINT64_C(84483670); break;
-        case 22: offset = (x * UINT64_C(838072422)) / UINT64_C(2147483648) + UINT64_C(91182168); break;
-        case 23: offset = (x * UINT64_C(800076492)) / UINT64_C(2147483648) + UINT64_C(98046282); break;
-        case 24: offset = (x * UINT64_C(762824345)) / UINT64_C(2147483648) + UINT64_C(105067062); break;
-        case 25: offset = (x * UINT64_C(726300211)) / UINT64_C(2147483648) + UINT64_C(112235980); break;
-        case 26: offset = (x * UINT64_C(690489753)) / UINT64_C(2147483648) + UINT64_C(119544589); break;
-        case 27: offset = (x * UINT64_C(655377152)) / UINT64_C(2147483648) + UINT64_C(126985089); break;
-        case 28: offset = (x * UINT64_C(620948633)) / UINT64_C(2147483648) + UINT64_C(134549602); break;
-        case 29: offset = (x * UINT64_C(587189248)) / UINT64_C(2147483648) + UINT64_C(142230842); break;
-        case 30: offset = (x * UINT64_C(554085376)) / UINT64_C(2147483648) + UINT64_C(150021559); break;
-        case 31: offset = (x * UINT64_C(521622937)) / UINT64_C(2147483648) + UINT64_C(157914932); break;
-        case 32: offset = (x * UINT64_C(489788313)) / UINT64_C(2147483648) + UINT64_C(165904358); break;
-        case 33: offset = (x * UINT64_C(458567936)) / UINT64_C(2147483648) + UINT64_C(173983538); break;
-        case 34: offset = (x * UINT64_C(427949158)) / UINT64_C(2147483648) + UINT64_C(182146247); break;
-        case 35: offset = (x * UINT64_C(397918720)) / UINT64_C(2147483648) + UINT64_C(190386723); break;
-        case 36: offset = (x * UINT64_C(368464230)) / UINT64_C(2147483648) + UINT64_C(198699269); break;
-        case 37: offset = (x * UINT64_C(339572940)) / UINT64_C(2147483648) + UINT64_C(207078586); break;
-        case 38: offset = (x * UINT64_C(311233228)) / UINT64_C(2147483648) + UINT64_C(215519334); break;
-        case 39: offset = (x * UINT64_C(283433216)) / UINT64_C(2147483648) + UINT64_C(224016526); break;
-        case 40: offset = (x * UINT64_C(256160921)) / UINT64_C(2147483648) + UINT64_C(232565482); break;
-        case 41: offset = (x * UINT64_C(229404876)) / UINT64_C(2147483648) + UINT64_C(241161645); break;
-        case 42: offset = (x * UINT64_C(203154585)) / UINT64_C(2147483648) + UINT64_C(249800400); break;
-        case 43: offset = (x * UINT64_C(177398425)) / UINT64_C(2147483648) + UINT64_C(258477761); break;
-        case 44: offset = (x * UINT64_C(152126310)) / UINT64_C(2147483648) + UINT64_C(267189486); break;
-        case 45: offset = (x * UINT64_C(127327795)) / UINT64_C(2147483648) + UINT64_C(275931692); break;
-        case 46: offset = (x * UINT64_C(102992486)) / UINT64_C(2147483648) + UINT64_C(284700723); break;
-        case 47: offset = (x * UINT64_C(79110553)) / UINT64_C(2147483648) + UINT64_C(293492962); break;
-        case 48: offset = (x * UINT64_C(55672576)) / UINT64_C(2147483648) + UINT64_C(302304868); break;
-        case 49: offset = (x * UINT64_C(32668979)) / UINT64_C(2147483648) + UINT64_C(311133176); break;
-        case 50: offset = (x * UINT64_C(10090496)) / UINT64_C(2147483648) + UINT64_C(319974730); break;
-        case 51: offset = UINT64_C(328826302) - (x * UINT64_C(12071424)) / UINT64_C(2147483648); break;
-        case 52: offset = UINT64_C(337684969) - (x * UINT64_C(33825587)) / UINT64_C(2147483648); break;
-        case 53: offset = UINT64_C(346547845) - (x * UINT64_C(55180390)) / UINT64_C(2147483648); break;
-        case 54: offset = UINT64_C(355412152) - (x * UINT64_C(76144025)) / UINT64_C(2147483648); break;
-        case 55: offset = UINT64_C(364275198) - (x * UINT64_C(96724428)) / UINT64_C(2147483648); break;
-        case 56: offset = UINT64_C(373134294) - (x * UINT64_C(116929126)) / UINT64_C(2147483648); break;
-        case 57: offset = UINT64_C(381986860) - (x * UINT64_C(136765491)) / UINT64_C(2147483648); break;
-        case 58: offset = UINT64_C(390830511) - (x * UINT64_C(156240947)) / UINT64_C(2147483648); break;
-        case 59: offset = UINT64_C(399662731) - (x * UINT64_C(175362252)) / UINT64_C(2147483648); break;
-        case 60: offset = UINT64_C(408481040) - (x * UINT64_C(194135910)) / UINT64_C(2147483648); break;
-        case 61: offset = UINT64_C(417283185) - (x * UINT64_C(212568576)) / UINT64_C(2147483648); break;
-        case 62: offset = UINT64_C(426066744) - (x * UINT64_C(230666240)) / UINT64_C(2147483648); break;
-        case 63: offset = UINT64_C(434829413) - (x * UINT64_C(248434841)) / UINT64_C(2147483648); break;
-        case 64: offset = UINT64_C(443568948) - (x * UINT64_C(265880166)) / UINT64_C(2147483648); break;
-        case 65: offset = UINT64_C(452282979) - (x * UINT64_C(283007488)) / UINT64_C(2147483648); break;
-        case 66: offset = UINT64_C(460969318) - (x * UINT64_C(299822182)) / UINT64_C(2147483648); break;
-        case 67: offset = UINT64_C(469625521) - (x * UINT64_C(316328908)) / UINT64_C(2147483648); break;
-        case 68: offset = UINT64_C(478249365) - (x * UINT64_C(332532531)) / UINT64_C(2147483648); break;
-        case 69: offset = UINT64_C(486838465) - (x * UINT64_C(348437401)) / UINT64_C(2147483648); break;
-        case 70: offset = UINT64_C(495390423) - (x * UINT64_C(364047667)) / UINT64_C(2147483648); break;
-        case 71: offset = UINT64_C(503902857) - (x * UINT64_C(379367321)) / UINT64_C(2147483648); break;
-        case 72: offset = UINT64_C(512373273) - (x * UINT64_C(394400000)) / UINT64_C(2147483648); break;
-        case 73: offset = UINT64_C(520799176) - (x * UINT64_C(409149184)) / UINT64_C(2147483648); break;
-        case 74: offset = UINT64_C(529177916) - (x * UINT64_C(423617945)) / UINT64_C(2147483648); break;
-        case 75: offset = UINT64_C(537507034) - (x * UINT64_C(437809561)) / UINT64_C(2147483648); break;
-        case 76: offset = UINT64_C(545783479) - (x * UINT64_C(451726182)) / UINT64_C(2147483648); break;
-        case 77: offset = UINT64_C(554004649) - (x * UINT64_C(465370624)) / UINT64_C(2147483648); break;
-        case 78: offset = UINT64_C(562167573) - (x * UINT64_C(478744985)) / UINT64_C(2147483648); break;
-        case 79: offset = UINT64_C(570269171) - (x * UINT64_C(491851110)) / UINT64_C(2147483648); break;
-        case 80: offset = UINT64_C(578306469) - (x * UINT64_C(504690944)) / UINT64_C(2147483648); break;
-        case 81: offset = UINT64_C(586276248) - (x * UINT64_C(517265971)) / UINT64_C(2147483648); break;
-        case 82: offset = UINT64_C(594174863) - (x * UINT64_C(529576960)) / UINT64_C(2147483648); break;
-        case 83: offset = UINT64_C(601998920) - (x * UINT64_C(541625036)) / UINT64_C(2147483648); break;
-        case 84: offset = UINT64_C(609744880) - (x * UINT64_C(553411072)) / UINT64_C(2147483648); break;
-        case 85: offset = UINT64_C(617408856) - (x * UINT64_C(564935372)) / UINT64_C(2147483648); break;
-        case 86: offset = UINT64_C(624987032) - (x * UINT64_C(576198348)) / UINT64_C(2147483648); break;
-        case 87: offset = UINT64_C(632475117) - (x * UINT64_C(587199692)) / UINT64_C(2147483648); break;
-        case 88: offset = UINT64_C(639868917) - (x * UINT64_C(597939251)) / UINT64_C(2147483648); break;
-        case 89: offset = UINT64_C(647163949) - (x * UINT64_C(608416460)) / UINT64_C(2147483648); break;
-        case 90: offset = UINT64_C(654355644) - (x * UINT64_C(618630656)) / UINT64_C(2147483648); break;
-        case 91: offset = UINT64_C(661438983) - (x * UINT64_C(628580556)) / UINT64_C(2147483648); break;
-        case 92: offset = UINT64_C(668409025) - (x * UINT64_C(638265036)) / UINT64_C(2147483648); break;
-        case 93: offset = UINT64_C(675260430) - (x * UINT64_C(647682457)) / UINT64_C(2147483648); break;
-        case 94: offset = UINT64_C(681987820) - (x * UINT64_C(656831180)) / UINT64_C(2147483648); break;
-        case 95: offset = UINT64_C(688585437) - (x * UINT64_C(665709107)) / UINT64_C(2147483648); break;
-        case 96: offset = UINT64_C(695047358) - (x * UINT64_C(674313984)) / UINT64_C(2147483648); break;
-        case 97: offset = UINT64_C(701367334) - (x * UINT64_C(682643200)) / UINT64_C(2147483648); break;
-        case 98: offset = UINT64_C(707538979) - (x * UINT64_C(690694041)) / UINT64_C(2147483648); break;
-        case 99: offset = UINT64_C(713555721) - (x * UINT64_C(698463641)) / UINT64_C(2147483648); break;
-        case 100: offset = UINT64_C(719410365) - (x * UINT64_C(705948416)) / UINT64_C(2147483648); break;
-        case 101: offset = UINT64_C(725095989) - (x * UINT64_C(713145241)) / UINT64_C(2147483648); break;
-        case 102: offset = UINT64_C(730604666) - (x * UINT64_C(720049817)) / UINT64_C(2147483648); break;
-        case 103: offset = UINT64_C(735929187) - (x * UINT64_C(726658867)) / UINT64_C(2147483648); break;
-        case 104: offset = UINT64_C(741060687) - (x * UINT64_C(732967168)) / UINT64_C(2147483648); break;
-        case 105: offset = UINT64_C(745991649) - (x * UINT64_C(738971289)) / UINT64_C(2147483648); break;
-        case 106: offset = UINT64_C(750712608) - (x * UINT64_C(744665548)) / UINT64_C(2147483648); break;
-        case 107: offset = UINT64_C(755215037) - (x * UINT64_C(750045542)) / UINT64_C(2147483648); break;
-        case 108: offset = UINT64_C(759489399) - (x * UINT64_C(755105792)) / UINT64_C(2147483648); break;
-        case 109: offset = UINT64_C(763525852) - (x * UINT64_C(759840614)) / UINT64_C(2147483648); break;
-        case 110: offset = UINT64_C(767314730) - (x * UINT64_C(764244684)) / UINT64_C(2147483648); break;
-        case 111: offset = UINT64_C(770845263) - (x * UINT64_C(768311552)) / UINT64_C(2147483648); break;
-        case 112: offset = UINT64_C(774107026) - (x * UINT64_C(772035328)) / UINT64_C(2147483648); break;
-        case 113: offset = UINT64_C(777088774) - (x * UINT64_C(775409356)) / UINT64_C(2147483648); break;
-        case 114: offset = UINT64_C(779779064) - (x * UINT64_C(778426931)) / UINT64_C(2147483648); break;
-        case 115: offset = UINT64_C(782165831) - (x * UINT64_C(781080832)) / UINT64_C(2147483648); break;
-        case 116: offset = UINT64_C(784237169) - (x * UINT64_C(783364198)) / UINT64_C(2147483648); break;
-        case 117: offset = UINT64_C(785980261) - (x * UINT64_C(785269350)) / UINT64_C(2147483648); break;
-        case 118: offset = UINT64_C(787382157) - (x * UINT64_C(786788659)) / UINT64_C(2147483648); break;
-        case 119: offset = UINT64_C(788429205) - (x * UINT64_C(787913932)) / UINT64_C(2147483648); break;
-        case 120: offset = UINT64_C(789107606) - (x * UINT64_C(788637030)) / UINT64_C(2147483648); break;
-        case 121: offset = UINT64_C(789403132) - (x * UINT64_C(788949555)) / UINT64_C(2147483648); break;
-        case 122: offset = UINT64_C(789301160) - (x * UINT64_C(788842905)) / UINT64_C(2147483648); break;
-        case 123: offset = UINT64_C(788786079) - (x * UINT64_C(788307660)) / UINT64_C(2147483648); break;
-        case 124: offset = UINT64_C(787842503) - (x * UINT64_C(787334860)) / UINT64_C(2147483648); break;
-        case 125: offset = UINT64_C(786454436) - (x * UINT64_C(785915136)) / UINT64_C(2147483648); break;
-        case 126: offset = UINT64_C(784605055) - (x * UINT64_C(784038502)) / UINT64_C(2147483648); break;
-        case 127: offset = UINT64_C(782599926) - (x * UINT64_C(782019072)) / UINT64_C(2147483648); break;
-        default: offset = 0; break;
-        }
-        if (offset > x) {
-            offset = x;
-        }
-        return offset;
+        return intNd<1>(*this).valueRaw(x);
+    }
+
+    cursor at(const uint64_t x) const noexcept {
+        return intNd<1>(*this).at(x);
+    }
+    // out[i] = value(x0 + i).
+    void generate(const uint64_t x0, const size_t count, uint32_t* out) const noexcept {
+        intNd<1>(*this).generate(x0, count, out);
+    }
+
+    static uint32_t getOffsetU32(const uint32_t x) noexcept {
+        return intNd<1>::getOffsetU32(x);
     }
+    static constexpr const auto& s_offsetLines = offset_table_t<1>::s_offsetLines;
 };
 
 struct int2d {
@@ -195,212 +2162,50 @@ struct int2d {
     uint32v2_t cellSize = { 64, 64 }; // 2..UINT32_MAX
     uint32_t seed = 0;
 
-    uint32_t value(const uint64_t x, const uint64_t y) const noexcept {
-        uint32_t s = valueShifted(x, y);
-        if (s < UINT32_MAX / 2) {
-            return s - getOffsetU32(s);
+    using prepared = intNd<2>::prepared;
+    using locality_t = intNd<2>::locality_t;
+
+    // The shift fields of the region [x0, x0 + width) x [y0, y0 + height).
+    struct shifts : intNd<2>::shifts {
+        shifts() = default;
+        shifts(const uint32v2_t& cellSize, const uint64_t x0, const uint64_t y0,
+                const uint32_t width, const uint32_t height)
+            : intNd<2>::shifts({ cellSize.x, cellSize.y }, { x0, y0 }, { width, height }) {
         }
-        s -= UINT32_MAX / 2;
-        s = UINT32_MAX / 2 - s;
-        s -= getOffsetU32(s);
-        s = UINT32_MAX / 2 - s;
-        s += UINT32_MAX / 2;
-        return s;
+    };
+
+    operator intNd<2>() const noexcept {
+        return intNd<2>({ cellSize.x, cellSize.y }, seed);
     }
 
+    uint32_t value(const uint64_t x, const uint64_t y) const noexcept {
+        return intNd<2>(*this).value(x, y);
+    }
+    // (x, y) inside the region of the shifts
+    uint32_t value(const uint64_t x, const uint64_t y, const shifts& fields) const noexcept {
+        return intNd<2>(*this).value(x, y, fields);
+    }
     uint32_t valueShifted(const uint64_t x, const uint64_t y) const noexcept {
-        int1d n;
-        n.seed = 12;
-        n.cellSize = cellSize.x;
-        const uint32_t offset_x = utils::lerp_u32(n.value(x), UINT32_MAX, cellSize.x / 2);
-        n.seed = 34;
-        n.cellSize = cellSize.y;
-        const uint32_t offset_y = utils::lerp_u32(n.value(y), UINT32_MAX, cellSize.y / 2);
-        return valueRaw(x + offset_y, y + offset_x);
+        return intNd<2>(*this).valueShifted(x, y);
+    }
+    uint32_t valueShifted(const uint64_t x, const uint64_t y, const shifts& fields) const noexcept {
+        return intNd<2>(*this).valueShifted(x, y, fields);
     }
-
     uint32_t valueRaw(const uint64_t x, const uint64_t y) const noexcept {
-        const uint64_t cellIdx_x = x / cellSize.x;
-        const uint64_t cellIdx_y = y / cellSize.y;
-        const uint64_t cell_x = cellIdx_x * cellSize.x;
-        const uint64_t cell_y = cellIdx_y * cellSize.y;
-        const uint64_t t_x = x - cell_x;
-        const uint64_t t_y = y - cell_y;
-        uint64_t seedSrc[2];
-
-        constexpr uint64_t x_c = UINT64_MAX;
-        constexpr uint64_t cellSize_x_c = 32;
-        constexpr uint64_t cellIdx_x_c = x_c / cellSize_x_c;
-        constexpr uint64_t cell_x_c = cellIdx_x_c * cellSize_x_c;
-        constexpr uint64_t t_x_c = x_c - cell_x_c;
-        constexpr uint64_t v_c = utils::lerp_u32(t_x_c, cellSize_x_c - 1, INT32_MAX, UINT32_MAX);
-        static_assert(v_c == UINT32_MAX, "error");
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y;
-        const uint32_t seed00 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y;
-        const uint32_t seed01 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y + cellSize.y;
-        const uint32_t seed10 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y + cellSize.y;
-        const uint32_t seed11 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        const uint32_t seed0 = utils::lerp_u32(t_x, cellSize.x - 1, seed00, seed01);
-        const uint32_t seed1 = utils::lerp_u32(t_x, cellSize.x - 1, seed10, seed11);
-
-        return utils::lerp_u32(t_y, cellSize.y - 1, seed0, seed1);
-    }
-
-    static uint32_t getOffsetU32(const uint32_t x_) noexcept {
-        if (x_ == 0) {
-            return 0;
-        }
-        constexpr uint32_t size = (UINT32_MAX / 2) / 128 + 1;
-        const uint64_t x = x_;
-        uint64_t offset = 0;
-        switch (x_ / size) {
-        case 0: offset = (x * UINT64_C(2142268877)) / UINT64_C(2147483648) - UINT64_C(39056); break;
-        case 1: offset = (x * UINT64_C(2141451468)) / UINT64_C(2147483648) - UINT64_C(1817); break;
-        case 2: offset = (x * UINT64_C(2129167462)) / UINT64_C(2147483648) + UINT64_C(202859); break;
-        case 3: offset = (x * UINT64_C(2115453798)) / UINT64_C(2147483648) + UINT64_C(538389); break;
-        case 4: offset = (x * UINT64_C(2100348825)) / UINT64_C(2147483648) + UINT64_C(1025874); break;
-        case 5: offset = (x * UINT64_C(2083890534)) / UINT64_C(2147483648) + UINT64_C(1685533); break;
-        case 6: offset = (x * UINT64_C(2066116044)) / UINT64_C(2147483648) + UINT64_C(2536735); break;
-        case 7: offset = (x * UINT64_C(2047062220)) / UINT64_C(2147483648) + UINT64_C(3597995); break;
-        case 8: offset = (x * UINT64_C(2026765977)) / UINT64_C(2147483648) + UINT64_C(4886959); break;
-        case 9: offset = (x * UINT64_C(2005262899)) / UINT64_C(2147483648) + UINT64_C(6420504); break;
-        case 10: offset = (x * UINT64_C(1982589081)) / UINT64_C(2147483648) + UINT64_C(8214629); break;
-        case 11: offset = (x * UINT64_C(1958778931)) / UINT64_C(2147483648) + UINT64_C(10284639); break;
-        case 12: offset = (x * UINT64_C(1933867827)) / UINT64_C(2147483648) + UINT64_C(12644938); break;
-        case 13: offset = (x * UINT64_C(1907889971)) / UINT64_C(2147483648) + UINT64_C(15309221); break;
-        case 14: offset = (x * UINT64_C(1880879001)) / UINT64_C(2147483648) + UINT64_C(18290445); break;
-        case 15: offset = (x * UINT64_C(1852868556)) / UINT64_C(2147483648) + UINT64_C(21600776); break;
-        case 16: offset = (x * UINT64_C(1823891507)) / UINT64_C(2147483648) + UINT64_C(25251693); break;
-        case 17: offset = (x * UINT64_C(1793980928)) / UINT64_C(2147483648) + UINT64_C(29253872); break;
-        case 18: offset = (x * UINT64_C(1763168716)) / UINT64_C(2147483648) + UINT64_C(33617384); break;
-        case 19: offset = (x * UINT64_C(1731486720)) / UINT64_C(2147483648) + UINT64_C(38351557); break;
-        case 20: offset = (x * UINT64_C(1698966476)) / UINT64_C(2147483648) + UINT64_C(43465024); break;
-        case 21: offset = (x * UINT64_C(1665638809)) / UINT64_C(2147483648) + UINT64_C(48965796); break;
-        case 22: offset = (x * UINT64_C(1631534643)) / UINT64_C(2147483648) + UINT64_C(54861144); break;
-        case 23: offset = (x * UINT64_C(1596684083)) / UINT64_C(2147483648) + UINT64_C(61157763); break;
-        case 24: offset = (x * UINT64_C(1561117081)) / UINT64_C(2147483648) + UINT64_C(67861669); break;
-        case 25: offset = (x * UINT64_C(1524863180)) / UINT64_C(2147483648) + UINT64_C(74978258); break;
-        case 26: offset = (x * UINT64_C(1487951462)) / UINT64_C(2147483648) + UINT64_C(82512328); break;
-        case 27: offset = (x * UINT64_C(1450410854)) / UINT64_C(2147483648) + UINT64_C(90468026); break;
-        case 28: offset = (x * UINT64_C(1412269414)) / UINT64_C(2147483648) + UINT64_C(98849014); break;
-        case 29: offset = (x * UINT64_C(1373555660)) / UINT64_C(2147483648) + UINT64_C(107658192); break;
-        case 30: offset = (x * UINT64_C(1334296780)) / UINT64_C(2147483648) + UINT64_C(116898103); break;
-        case 31: offset = (x * UINT64_C(1294520320)) / UINT64_C(2147483648) + UINT64_C(126570567); break;
-        case 32: offset = (x * UINT64_C(1254253670)) / UINT64_C(2147483648) + UINT64_C(136676797); break;
-        case 33: offset = (x * UINT64_C(1213522841)) / UINT64_C(2147483648) + UINT64_C(147217720); break;
-        case 34: offset = (x * UINT64_C(1172354406)) / UINT64_C(2147483648) + UINT64_C(158193507); break;
-        case 35: offset = (x * UINT64_C(1130774476)) / UINT64_C(2147483648) + UINT64_C(169603829); break;
-        case 36: offset = (x * UINT64_C(1088808345)) / UINT64_C(2147483648) + UINT64_C(181447976); break;
-        case 37: offset = (x * UINT64_C(1046481766)) / UINT64_C(2147483648) + UINT64_C(193724516); break;
-        case 38: offset = (x * UINT64_C(1003819315)) / UINT64_C(2147483648) + UINT64_C(206431760); break;
-        case 39: offset = (x * UINT64_C(960846080)) / UINT64_C(2147483648) + UINT64_C(219567286); break;
-        case 40: offset = (x * UINT64_C(917585971)) / UINT64_C(2147483648) + UINT64_C(233128457); break;
-        case 41: offset = (x * UINT64_C(874063360)) / UINT64_C(2147483648) + UINT64_C(247111925); break;
-        case 42: offset = (x * UINT64_C(830301952)) / UINT64_C(2147483648) + UINT64_C(261513989); break;
-        case 43: offset = (x * UINT64_C(786325043)) / UINT64_C(2147483648) + UINT64_C(276330533); break;
-        case 44: offset = (x * UINT64_C(742155827)) / UINT64_C(2147483648) + UINT64_C(291556928); break;
-        case 45: offset = (x * UINT64_C(697817241)) / UINT64_C(2147483648) + UINT64_C(307188093); break;
-        case 46: offset = (x * UINT64_C(653331712)) / UINT64_C(2147483648) + UINT64_C(323218593); break;
-        case 47: offset = (x * UINT64_C(608721817)) / UINT64_C(2147483648) + UINT64_C(339642411); break;
-        case 48: offset = (x * UINT64_C(564009164)) / UINT64_C(2147483648) + UINT64_C(356453367); break;
-        case 49: offset = (x * UINT64_C(519215411)) / UINT64_C(2147483648) + UINT64_C(373644755); break;
-        case 50: offset = (x * UINT64_C(474362265)) / UINT64_C(2147483648) + UINT64_C(391209342); break;
-        case 51: offset = (x * UINT64_C(429470976)) / UINT64_C(2147483648) + UINT64_C(409139569); break;
-        case 52: offset = (x * UINT64_C(384562176)) / UINT64_C(2147483648) + UINT64_C(427427628); break;
-        case 53: offset = (x * UINT64_C(339656652)) / UINT64_C(2147483648) + UINT64_C(446065167); break;
-        case 54: offset = (x * UINT64_C(294774681)) / UINT64_C(2147483648) + UINT64_C(465043562); break;
-        case 55: offset = (x * UINT64_C(249936742)) / UINT64_C(2147483648) + UINT64_C(484353624); break;
-        case 56: offset = (x * UINT64_C(205162188)) / UINT64_C(2147483648) + UINT64_C(503986179); break;
-        case 57: offset = (x * UINT64_C(160471193)) / UINT64_C(2147483648) + UINT64_C(523931234); break;
-        case 58: offset = (x * UINT64_C(115882752)) / UINT64_C(2147483648) + UINT64_C(544178857); break;
-        case 59: offset = (x * UINT64_C(71416217)) / UINT64_C(2147483648) + UINT64_C(564718506); break;
-        case 60: offset = (x * UINT64_C(27090432)) / UINT64_C(2147483648) + UINT64_C(585539428); break;
-        case 61: offset = UINT64_C(606630474) - (x * UINT64_C(17075865)) / UINT64_C(2147483648); break;
-        case 62: offset = UINT64_C(627980131) - (x * UINT64_C(61064089)) / UINT64_C(2147483648); break;
-        case 63: offset = UINT64_C(649576629) - (x * UINT64_C(104856012)) / UINT64_C(2147483648); break;
-        case 64: offset = UINT64_C(671407845) - (x * UINT64_C(148433561)) / UINT64_C(2147483648); break;
-        case 65: offset = UINT64_C(693461494) - (x * UINT64_C(191779174)) / UINT64_C(2147483648); break;
-        case 66: offset = UINT64_C(715724697) - (x * UINT64_C(234874931)) / UINT64_C(2147483648); break;
-        case 67: offset = UINT64_C(738184419) - (x * UINT64_C(277703424)) / UINT64_C(2147483648); break;
-        case 68: offset = UINT64_C(760827329) - (x * UINT64_C(320247449)) / UINT64_C(2147483648); break;
-        case 69: offset = UINT64_C(783639913) - (x * UINT64_C(362490214)) / UINT64_C(2147483648); break;
-        case 70: offset = UINT64_C(806608011) - (x * UINT64_C(404414464)) / UINT64_C(2147483648); break;
-        case 71: offset = UINT64_C(829717542) - (x * UINT64_C(446003814)) / UINT64_C(2147483648); break;
-        case 72: offset = UINT64_C(852953897) - (x * UINT64_C(487241625)) / UINT64_C(2147483648); break;
-        case 73: offset = UINT64_C(876302429) - (x * UINT64_C(528111872)) / UINT64_C(2147483648); break;
-        case 74: offset = UINT64_C(899747906) - (x * UINT64_C(568598169)) / UINT64_C(2147483648); break;
-        case 75: offset = UINT64_C(923275044) - (x * UINT64_C(608684697)) / UINT64_C(2147483648); break;
-        case 76: offset = UINT64_C(946868157) - (x * UINT64_C(648355584)) / UINT64_C(2147483648); break;
-        case 77: offset = UINT64_C(970511279) - (x * UINT64_C(687595110)) / UINT64_C(2147483648); break;
-        case 78: offset = UINT64_C(994188452) - (x * UINT64_C(726388172)) / UINT64_C(2147483648); break;
-        case 79: offset = UINT64_C(1017882889) - (x * UINT64_C(764718899)) / UINT64_C(2147483648); break;
-        case 80: offset = UINT64_C(1041578198) - (x * UINT64_C(802572646)) / UINT64_C(2147483648); break;
-        case 81: offset = UINT64_C(1065257356) - (x * UINT64_C(839934310)) / UINT64_C(2147483648); break;
-        case 82: offset = UINT64_C(1088902884) - (x * UINT64_C(876788633)) / UINT64_C(2147483648); break;
-        case 83: offset = UINT64_C(1112497510) - (x * UINT64_C(913121228)) / UINT64_C(2147483648); break;
-        case 84: offset = UINT64_C(1136023393) - (x * UINT64_C(948917350)) / UINT64_C(2147483648); break;
-        case 85: offset = UINT64_C(1159462617) - (x * UINT64_C(984162662)) / UINT64_C(2147483648); break;
-        case 86: offset = UINT64_C(1182796686) - (x * UINT64_C(1018842470)) / UINT64_C(2147483648); break;
-        case 87: offset = UINT64_C(1206007322) - (x * UINT64_C(1052942899)) / UINT64_C(2147483648); break;
-        case 88: offset = UINT64_C(1229075672) - (x * UINT64_C(1086449715)) / UINT64_C(2147483648); break;
-        case 89: offset = UINT64_C(1251982550) - (x * UINT64_C(1119348684)) / UINT64_C(2147483648); break;
-        case 90: offset = UINT64_C(1274708869) - (x * UINT64_C(1151626188)) / UINT64_C(2147483648); break;
-        case 91: offset = UINT64_C(1297234894) - (x * UINT64_C(1183268147)) / UINT64_C(2147483648); break;
-        case 92: offset = UINT64_C(1319541115) - (x * UINT64_C(1214261248)) / UINT64_C(2147483648); break;
-        case 93: offset = UINT64_C(1341607337) - (x * UINT64_C(1244591667)) / UINT64_C(2147483648); break;
-        case 94: offset = UINT64_C(1363413114) - (x * UINT64_C(1274245683)) / UINT64_C(2147483648); break;
-        case 95: offset = UINT64_C(1384938174) - (x * UINT64_C(1303210240)) / UINT64_C(2147483648); break;
-        case 96: offset = UINT64_C(1406161633) - (x * UINT64_C(1331471872)) / UINT64_C(2147483648); break;
-        case 97: offset = UINT64_C(1427062291) - (x * UINT64_C(1359017113)) / UINT64_C(2147483648); break;
-        case 98: offset = UINT64_C(1447619101) - (x * UINT64_C(1385833113)) / UINT64_C(2147483648); break;
-        case 99: offset = UINT64_C(1467810242) - (x * UINT64_C(1411906406)) / UINT64_C(2147483648); break;
-        case 100: offset = UINT64_C(1487613935) - (x * UINT64_C(1437223987)) / UINT64_C(2147483648); break;
-        case 101: offset = UINT64_C(1507008301) - (x * UINT64_C(1461773107)) / UINT64_C(2147483648); break;
-        case 102: offset = UINT64_C(1525970998) - (x * UINT64_C(1485540812)) / UINT64_C(2147483648); break;
-        case 103: offset = UINT64_C(1544479215) - (x * UINT64_C(1508513945)) / UINT64_C(2147483648); break;
-        case 104: offset = UINT64_C(1562510208) - (x * UINT64_C(1530679808)) / UINT64_C(2147483648); break;
-        case 105: offset = UINT64_C(1580040850) - (x * UINT64_C(1552025600)) / UINT64_C(2147483648); break;
-        case 106: offset = UINT64_C(1597047885) - (x * UINT64_C(1572538726)) / UINT64_C(2147483648); break;
-        case 107: offset = UINT64_C(1613507461) - (x * UINT64_C(1592206233)) / UINT64_C(2147483648); break;
-        case 108: offset = UINT64_C(1629395943) - (x * UINT64_C(1611015782)) / UINT64_C(2147483648); break;
-        case 109: offset = UINT64_C(1644688752) - (x * UINT64_C(1628954265)) / UINT64_C(2147483648); break;
-        case 110: offset = UINT64_C(1659361658) - (x * UINT64_C(1646009344)) / UINT64_C(2147483648); break;
-        case 111: offset = UINT64_C(1673390105) - (x * UINT64_C(1662168627)) / UINT64_C(2147483648); break;
-        case 112: offset = UINT64_C(1686748522) - (x * UINT64_C(1677418905)) / UINT64_C(2147483648); break;
-        case 113: offset = UINT64_C(1699412299) - (x * UINT64_C(1691748403)) / UINT64_C(2147483648); break;
-        case 114: offset = UINT64_C(1711355273) - (x * UINT64_C(1705143910)) / UINT64_C(2147483648); break;
-        case 115: offset = UINT64_C(1722551704) - (x * UINT64_C(1717593036)) / UINT64_C(2147483648); break;
-        case 116: offset = UINT64_C(1732975518) - (x * UINT64_C(1729083340)) / UINT64_C(2147483648); break;
-        case 117: offset = UINT64_C(1742600209) - (x * UINT64_C(1739602227)) / UINT64_C(2147483648); break;
-        case 118: offset = UINT64_C(1751399116) - (x * UINT64_C(1749137254)) / UINT64_C(2147483648); break;
-        case 119: offset = UINT64_C(1759344906) - (x * UINT64_C(1757675571)) / UINT64_C(2147483648); break;
-        case 120: offset = UINT64_C(1766410283) - (x * UINT64_C(1765204684)) / UINT64_C(2147483648); break;
-        case 121: offset = UINT64_C(1772567461) - (x * UINT64_C(1771711897)) / UINT64_C(2147483648); break;
-        case 122: offset = UINT64_C(1777788553) - (x * UINT64_C(1777184716)) / UINT64_C(2147483648); break;
-        case 123: offset = UINT64_C(1782045084) - (x * UINT64_C(1781610342)) / UINT64_C(2147483648); break;
-        case 124: offset = UINT64_C(1785308528) - (x * UINT64_C(1784976230)) / UINT64_C(2147483648); break;
-        case 125: offset = UINT64_C(1787549565) - (x * UINT64_C(1787269324)) / UINT64_C(2147483648); break;
-        case 126: offset = UINT64_C(1788739322) - (x * UINT64_C(1788477337)) / UINT64_C(2147483648); break;
-        case 127: offset = UINT64_C(1788906289) - (x * UINT64_C(1788645888)) / UINT64_C(2147483648); break;
-        default: offset = 0; break;
-        }
-        if (offset > x) {
-            offset = x;
-        }
-        return offset;
+        return intNd<2>(*this).valueRaw(x, y);
     }
+
+    // Fills out[row * stride + col] with value(x0 + col, y0 + row).
+    void fill(const uint64_t x0, const uint64_t y0,
+            const uint32_t width, const uint32_t height,
+            uint32_t* out, const size_t stride) const {
+        intNd<2>(*this).fill(x0, y0, width, height, out, stride);
+    }
+
+    static uint32_t getOffsetU32(const uint32_t x) noexcept {
+        return intNd<2>::getOffsetU32(x);
+    }
+    static constexpr const auto& s_offsetLines = offset_table_t<2>::s_offsetLines;
 };
 
 struct int3d {
@@ -412,239 +2217,56 @@ struct int3d {
     uint32v3_t cellSize = { 64, 64, 64 }; // 2..UINT32_MAX
     uint32_t seed = 0;
 
-    uint32_t value(const uint64_t x, const uint64_t y, const uint64_t z) const noexcept {
-        uint32_t s = valueShifted(x, y, z);
-        if (s < UINT32_MAX / 2) {
-            return s - getOffsetU32(s);
+    using prepared = intNd<3>::prepared;
+    using locality_t = intNd<3>::locality_t;
+    using slice_t = intNd<3>::slice_t;
+    using slab_t = intNd<3>::slab_t;
+
+    // The shift fields of the box [x0, x0 + width) x [y0, y0 + height) x [z0, z0 + depth).
+    struct shifts : intNd<3>::shifts {
+        shifts() = default;
+        shifts(const uint32v3_t& cellSize, const uint64_t x0, const uint64_t y0, const uint64_t z0,
+                const uint32_t width, const uint32_t height, const uint32_t depth)
+            : intNd<3>::shifts({ cellSize.x, cellSize.y, cellSize.z },
+                { x0, y0, z0 }, { width, height, depth }) {
         }
-        s -= UINT32_MAX / 2;
-        s = UINT32_MAX / 2 - s;
-        s -= getOffsetU32(s);
-        s = UINT32_MAX / 2 - s;
-        s += UINT32_MAX / 2;
-        return s;
+    };
+
+    operator intNd<3>() const noexcept {
+        return intNd<3>({ cellSize.x, cellSize.y, cellSize.z }, seed);
     }
 
+    uint32_t value(const uint64_t x, const uint64_t y, const uint64_t z) const noexcept {
+        return intNd<3>(*this).value(x, y, z);
+    }
+    // (x, y, z) inside the box of the shifts
+    uint32_t value(const uint64_t x, const uint64_t y, const uint64_t z,
+            const shifts& fields) const noexcept {
+        return intNd<3>(*this).value(x, y, z, fields);
+    }
     uint32_t valueShifted(const uint64_t x, const uint64_t y, const uint64_t z) const noexcept {
-        int1d n;
-        n.seed = 12;
-        n.cellSize = cellSize.x;
-        const uint32_t offset_x = utils::lerp_u32(n.value(x), UINT32_MAX, cellSize.x / 2);
-        n.seed = 34;
-        n.cellSize = cellSize.y;
-        const uint32_t offset_y = utils::lerp_u32(n.value(y), UINT32_MAX, cellSize.y / 2);
-        n.seed = 56;
-        n.cellSize = cellSize.z;
-        const uint32_t offset_z = utils::lerp_u32(n.value(z), UINT32_MAX, cellSize.z / 2);
-        return valueRaw(x + offset_y, y + offset_z, z + offset_x);
+        return intNd<3>(*this).valueShifted(x, y, z);
+    }
+    uint32_t valueShifted(const uint64_t x, const uint64_t y, const uint64_t z,
+            const shifts& fields) const noexcept {
+        return intNd<3>(*this).valueShifted(x, y, z, fields);
     }
-
     uint32_t valueRaw(const uint64_t x, const uint64_t y, const uint64_t z) const noexcept {
-        const uint64_t cellIdx_x = x / cellSize.x;
-        const uint64_t cellIdx_y = y / cellSize.y;
-        const uint64_t cellIdx_z = z / cellSize.z;
-        const uint64_t cell_x = cellIdx_x * cellSize.x;
-        const uint64_t cell_y = cellIdx_y * cellSize.y;
-        const uint64_t cell_z = cellIdx_z * cellSize.z;
-        const uint64_t t_x = x - cell_x;
-        const uint64_t t_y = y - cell_y;
-        const uint64_t t_z = z - cell_z;
-        uint64_t seedSrc[3];
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z;
-        const uint32_t seed000 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z;
-        const uint32_t seed001 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z;
-        const uint32_t seed010 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z;
-        const uint32_t seed011 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z + cellSize.z;
-        const uint32_t seed100 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z + cellSize.z;
-        const uint32_t seed101 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z + cellSize.z;
-        const uint32_t seed110 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z + cellSize.z;
-        const uint32_t seed111 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        const uint32_t seed00 = utils::lerp_u32(t_x, cellSize.x - 1, seed000, seed001);
-        const uint32_t seed01 = utils::lerp_u32(t_x, cellSize.x - 1, seed010, seed011);
-        const uint32_t seed10 = utils::lerp_u32(t_x, cellSize.x - 1, seed100, seed101);
-        const uint32_t seed11 = utils::lerp_u32(t_x, cellSize.x - 1, seed110, seed111);
-
-        const uint32_t seed0 = utils::lerp_u32(t_y, cellSize.y - 1, seed00, seed01);
-        const uint32_t seed1 = utils::lerp_u32(t_y, cellSize.y - 1, seed10, seed11);
-
-        return utils::lerp_u32(t_z, cellSize.z - 1, seed0, seed1);
-    }
-
-    static uint32_t getOffsetU32(const uint32_t x_) noexcept {
-        if (x_ == 0) {
-            return 0;
-        }
-        constexpr uint32_t size = (UINT32_MAX / 2) / 128 + 1;
-        const uint64_t x = x_;
-        uint64_t offset = 0;
-        switch (x_ / size) {
-        case 0: offset = (x * UINT64_C(2121864090)) / UINT64_C(2147483648) - UINT64_C(196487); break;
-        case 1: offset = (x * UINT64_C(2167263078)) / UINT64_C(2147483648) - UINT64_C(448241); break;
-        case 2: offset = (x * UINT64_C(2162528256)) / UINT64_C(2147483648) - UINT64_C(369701); break;
-        case 3: offset = (x * UINT64_C(2157885184)) / UINT64_C(2147483648) - UINT64_C(256373); break;
-        case 4: offset = (x * UINT64_C(2153261209)) / UINT64_C(2147483648) - UINT64_C(107350); break;
-        case 5: offset = (x * UINT64_C(2148585216)) / UINT64_C(2147483648) + UINT64_C(79915); break;
-        case 6: offset = (x * UINT64_C(2143788646)) / UINT64_C(2147483648) + UINT64_C(309518); break;
-        case 7: offset = (x * UINT64_C(2138805094)) / UINT64_C(2147483648) + UINT64_C(587035); break;
-        case 8: offset = (x * UINT64_C(2133569996)) / UINT64_C(2147483648) + UINT64_C(919487); break;
-        case 9: offset = (x * UINT64_C(2128021452)) / UINT64_C(2147483648) + UINT64_C(1315214); break;
-        case 10: offset = (x * UINT64_C(2122098534)) / UINT64_C(2147483648) + UINT64_C(1783932); break;
-        case 11: offset = (x * UINT64_C(2115744051)) / UINT64_C(2147483648) + UINT64_C(2336463); break;
-        case 12: offset = (x * UINT64_C(2108901478)) / UINT64_C(2147483648) + UINT64_C(2984901); break;
-        case 13: offset = (x * UINT64_C(2101517004)) / UINT64_C(2147483648) + UINT64_C(3742389); break;
-        case 14: offset = (x * UINT64_C(2093538611)) / UINT64_C(2147483648) + UINT64_C(4623134); break;
-        case 15: offset = (x * UINT64_C(2084916480)) / UINT64_C(2147483648) + UINT64_C(5642302); break;
-        case 16: offset = (x * UINT64_C(2075602739)) / UINT64_C(2147483648) + UINT64_C(6815981); break;
-        case 17: offset = (x * UINT64_C(2065551616)) / UINT64_C(2147483648) + UINT64_C(8161101); break;
-        case 18: offset = (x * UINT64_C(2054719334)) / UINT64_C(2147483648) + UINT64_C(9695382); break;
-        case 19: offset = (x * UINT64_C(2043064064)) / UINT64_C(2147483648) + UINT64_C(11437276); break;
-        case 20: offset = (x * UINT64_C(2030545715)) / UINT64_C(2147483648) + UINT64_C(13405945); break;
-        case 21: offset = (x * UINT64_C(2017126451)) / UINT64_C(2147483648) + UINT64_C(15621119); break;
-        case 22: offset = (x * UINT64_C(2002770227)) / UINT64_C(2147483648) + UINT64_C(18103103); break;
-        case 23: offset = (x * UINT64_C(1987443251)) / UINT64_C(2147483648) + UINT64_C(20872643); break;
-        case 24: offset = (x * UINT64_C(1971113062)) / UINT64_C(2147483648) + UINT64_C(23951022); break;
-        case 25: offset = (x * UINT64_C(1953749504)) / UINT64_C(2147483648) + UINT64_C(27359835); break;
-        case 26: offset = (x * UINT64_C(1935324262)) / UINT64_C(2147483648) + UINT64_C(31121008); break;
-        case 27: offset = (x * UINT64_C(1915811072)) / UINT64_C(2147483648) + UINT64_C(35256692); break;
-        case 28: offset = (x * UINT64_C(1895185049)) / UINT64_C(2147483648) + UINT64_C(39789354); break;
-        case 29: offset = (x * UINT64_C(1873423769)) / UINT64_C(2147483648) + UINT64_C(44741484); break;
-        case 30: offset = (x * UINT64_C(1850506291)) / UINT64_C(2147483648) + UINT64_C(50135746); break;
-        case 31: offset = (x * UINT64_C(1826413158)) / UINT64_C(2147483648) + UINT64_C(55994937); break;
-        case 32: offset = (x * UINT64_C(1801127577)) / UINT64_C(2147483648) + UINT64_C(62341640); break;
-        case 33: offset = (x * UINT64_C(1774633830)) / UINT64_C(2147483648) + UINT64_C(69198555); break;
-        case 34: offset = (x * UINT64_C(1746918246)) / UINT64_C(2147483648) + UINT64_C(76588204); break;
-        case 35: offset = (x * UINT64_C(1717969305)) / UINT64_C(2147483648) + UINT64_C(84532836); break;
-        case 36: offset = (x * UINT64_C(1687776460)) / UINT64_C(2147483648) + UINT64_C(93054699); break;
-        case 37: offset = (x * UINT64_C(1656331673)) / UINT64_C(2147483648) + UINT64_C(102175559); break;
-        case 38: offset = (x * UINT64_C(1623628032)) / UINT64_C(2147483648) + UINT64_C(111917036); break;
-        case 39: offset = (x * UINT64_C(1589660723)) / UINT64_C(2147483648) + UINT64_C(122300271); break;
-        case 40: offset = (x * UINT64_C(1554426624)) / UINT64_C(2147483648) + UINT64_C(133345986); break;
-        case 41: offset = (x * UINT64_C(1517924403)) / UINT64_C(2147483648) + UINT64_C(145074401); break;
-        case 42: offset = (x * UINT64_C(1480154009)) / UINT64_C(2147483648) + UINT64_C(157505345); break;
-        case 43: offset = (x * UINT64_C(1441117081)) / UINT64_C(2147483648) + UINT64_C(170658083); break;
-        case 44: offset = (x * UINT64_C(1400817715)) / UINT64_C(2147483648) + UINT64_C(184550991); break;
-        case 45: offset = (x * UINT64_C(1359260569)) / UINT64_C(2147483648) + UINT64_C(199202151); break;
-        case 46: offset = (x * UINT64_C(1316452864)) / UINT64_C(2147483648) + UINT64_C(214628614); break;
-        case 47: offset = (x * UINT64_C(1272402790)) / UINT64_C(2147483648) + UINT64_C(230846901); break;
-        case 48: offset = (x * UINT64_C(1227120281)) / UINT64_C(2147483648) + UINT64_C(247872692); break;
-        case 49: offset = (x * UINT64_C(1180617164)) / UINT64_C(2147483648) + UINT64_C(265720703); break;
-        case 50: offset = (x * UINT64_C(1132906752)) / UINT64_C(2147483648) + UINT64_C(284404791); break;
-        case 51: offset = (x * UINT64_C(1084003584)) / UINT64_C(2147483648) + UINT64_C(303938011); break;
-        case 52: offset = (x * UINT64_C(1033924147)) / UINT64_C(2147483648) + UINT64_C(324332287); break;
-        case 53: offset = (x * UINT64_C(982686361)) / UINT64_C(2147483648) + UINT64_C(345598558); break;
-        case 54: offset = (x * UINT64_C(930309580)) / UINT64_C(2147483648) + UINT64_C(367746740); break;
-        case 55: offset = (x * UINT64_C(876814438)) / UINT64_C(2147483648) + UINT64_C(390785742); break;
-        case 56: offset = (x * UINT64_C(822223718)) / UINT64_C(2147483648) + UINT64_C(414723050); break;
-        case 57: offset = (x * UINT64_C(766561587)) / UINT64_C(2147483648) + UINT64_C(439564994); break;
-        case 58: offset = (x * UINT64_C(709852928)) / UINT64_C(2147483648) + UINT64_C(465317014); break;
-        case 59: offset = (x * UINT64_C(652124979)) / UINT64_C(2147483648) + UINT64_C(491982881); break;
-        case 60: offset = (x * UINT64_C(593405747)) / UINT64_C(2147483648) + UINT64_C(519565365); break;
-        case 61: offset = (x * UINT64_C(533725440)) / UINT64_C(2147483648) + UINT64_C(548065528); break;
-        case 62: offset = (x * UINT64_C(473114931)) / UINT64_C(2147483648) + UINT64_C(577483401); break;
-        case 63: offset = (x * UINT64_C(411606784)) / UINT64_C(2147483648) + UINT64_C(607817461); break;
-        case 64: offset = (x * UINT64_C(349235200)) / UINT64_C(2147483648) + UINT64_C(639064597); break;
-        case 65: offset = (x * UINT64_C(286035609)) / UINT64_C(2147483648) + UINT64_C(671220272); break;
-        case 66: offset = (x * UINT64_C(222044723)) / UINT64_C(2147483648) + UINT64_C(704278460); break;
-        case 67: offset = (x * UINT64_C(157300531)) / UINT64_C(2147483648) + UINT64_C(738231600); break;
-        case 68: offset = (x * UINT64_C(91842611)) / UINT64_C(2147483648) + UINT64_C(773070399); break;
-        case 69: offset = (x * UINT64_C(25711923)) / UINT64_C(2147483648) + UINT64_C(808783888); break;
-        case 70: offset = UINT64_C(845359577) - (x * UINT64_C(41049548)) / UINT64_C(2147483648); break;
-        case 71: offset = UINT64_C(882783054) - (x * UINT64_C(108398131)) / UINT64_C(2147483648); break;
-        case 72: offset = UINT64_C(921038392) - (x * UINT64_C(176289280)) / UINT64_C(2147483648); break;
-        case 73: offset = UINT64_C(960107713) - (x * UINT64_C(244676864)) / UINT64_C(2147483648); break;
-        case 74: offset = UINT64_C(999971437) - (x * UINT64_C(313513676)) / UINT64_C(2147483648); break;
-        case 75: offset = UINT64_C(1040607884) - (x * UINT64_C(382750822)) / UINT64_C(2147483648); break;
-        case 76: offset = UINT64_C(1081993863) - (x * UINT64_C(452338790)) / UINT64_C(2147483648); break;
-        case 77: offset = UINT64_C(1124104067) - (x * UINT64_C(522226483)) / UINT64_C(2147483648); break;
-        case 78: offset = UINT64_C(1166911336) - (x * UINT64_C(592361728)) / UINT64_C(2147483648); break;
-        case 79: offset = UINT64_C(1210386147) - (x * UINT64_C(662690508)) / UINT64_C(2147483648); break;
-        case 80: offset = UINT64_C(1254497740) - (x * UINT64_C(733158860)) / UINT64_C(2147483648); break;
-        case 81: offset = UINT64_C(1299212571) - (x * UINT64_C(803710412)) / UINT64_C(2147483648); break;
-        case 82: offset = UINT64_C(1344495506) - (x * UINT64_C(874288384)) / UINT64_C(2147483648); break;
-        case 83: offset = UINT64_C(1390309053) - (x * UINT64_C(944834406)) / UINT64_C(2147483648); break;
-        case 84: offset = UINT64_C(1436613848) - (x * UINT64_C(1015289344)) / UINT64_C(2147483648); break;
-        case 85: offset = UINT64_C(1483368116) - (x * UINT64_C(1085592524)) / UINT64_C(2147483648); break;
-        case 86: offset = UINT64_C(1530528249) - (x * UINT64_C(1155682662)) / UINT64_C(2147483648); break;
-        case 87: offset = UINT64_C(1578048052) - (x * UINT64_C(1225496780)) / UINT64_C(2147483648); break;
-        case 88: offset = UINT64_C(1625879361) - (x * UINT64_C(1294971187)) / UINT64_C(2147483648); break;
-        case 89: offset = UINT64_C(1673972020) - (x * UINT64_C(1364041472)) / UINT64_C(2147483648); break;
-        case 90: offset = UINT64_C(1722272778) - (x * UINT64_C(1432640972)) / UINT64_C(2147483648); break;
-        case 91: offset = UINT64_C(1770726892) - (x * UINT64_C(1500703129)) / UINT64_C(2147483648); break;
-        case 92: offset = UINT64_C(1819277139) - (x * UINT64_C(1568160102)) / UINT64_C(2147483648); break;
-        case 93: offset = UINT64_C(1867863553) - (x * UINT64_C(1634942464)) / UINT64_C(2147483648); break;
-        case 94: offset = UINT64_C(1916424236) - (x * UINT64_C(1700980377)) / UINT64_C(2147483648); break;
-        case 95: offset = UINT64_C(1964894667) - (x * UINT64_C(1766202675)) / UINT64_C(2147483648); break;
-        case 96: offset = UINT64_C(2013208156) - (x * UINT64_C(1830537523)) / UINT64_C(2147483648); break;
-        case 97: offset = UINT64_C(2061295397) - (x * UINT64_C(1893911859)) / UINT64_C(2147483648); break;
-        case 98: offset = UINT64_C(2109084707) - (x * UINT64_C(1956251750)) / UINT64_C(2147483648); break;
-        case 99: offset = UINT64_C(2156501554) - (x * UINT64_C(2017481830)) / UINT64_C(2147483648); break;
-        case 100: offset = UINT64_C(2203469764) - (x * UINT64_C(2077526886)) / UINT64_C(2147483648); break;
-        case 101: offset = UINT64_C(2249909903) - (x * UINT64_C(2136309811)) / UINT64_C(2147483648); break;
-        case 102: offset = UINT64_C(2295740159) - (x * UINT64_C(2193752780)) / UINT64_C(2147483648); break;
-        case 103: offset = UINT64_C(2340876688) - (x * UINT64_C(2249777715)) / UINT64_C(2147483648); break;
-        case 104: offset = UINT64_C(2385232275) - (x * UINT64_C(2304304640)) / UINT64_C(2147483648); break;
-        case 105: offset = UINT64_C(2428717494) - (x * UINT64_C(2357253171)) / UINT64_C(2147483648); break;
-        case 106: offset = UINT64_C(2471240910) - (x * UINT64_C(2408542771)) / UINT64_C(2147483648); break;
-        case 107: offset = UINT64_C(2512707227) - (x * UINT64_C(2458090547)) / UINT64_C(2147483648); break;
-        case 108: offset = UINT64_C(2553019725) - (x * UINT64_C(2505814220)) / UINT64_C(2147483648); break;
-        case 109: offset = UINT64_C(2592078361) - (x * UINT64_C(2551629875)) / UINT64_C(2147483648); break;
-        case 110: offset = UINT64_C(2629780462) - (x * UINT64_C(2595452825)) / UINT64_C(2147483648); break;
-        case 111: offset = UINT64_C(2666021238) - (x * UINT64_C(2637198233)) / UINT64_C(2147483648); break;
-        case 112: offset = UINT64_C(2700692475) - (x * UINT64_C(2676779622)) / UINT64_C(2147483648); break;
-        case 113: offset = UINT64_C(2733683662) - (x * UINT64_C(2714110208)) / UINT64_C(2147483648); break;
-        case 114: offset = UINT64_C(2764881660) - (x * UINT64_C(2749102540)) / UINT64_C(2147483648); break;
-        case 115: offset = UINT64_C(2794170358) - (x * UINT64_C(2781668147)) / UINT64_C(2147483648); break;
-        case 116: offset = UINT64_C(2821431014) - (x * UINT64_C(2811717939)) / UINT64_C(2147483648); break;
-        case 117: offset = UINT64_C(2846542380) - (x * UINT64_C(2839162368)) / UINT64_C(2147483648); break;
-        case 118: offset = UINT64_C(2869379876) - (x * UINT64_C(2863910553)) / UINT64_C(2147483648); break;
-        case 119: offset = UINT64_C(2889816795) - (x * UINT64_C(2885871616)) / UINT64_C(2147483648); break;
-        case 120: offset = UINT64_C(2907723242) - (x * UINT64_C(2904953548)) / UINT64_C(2147483648); break;
-        case 121: offset = UINT64_C(2922966681) - (x * UINT64_C(2921063833)) / UINT64_C(2147483648); break;
-        case 122: offset = UINT64_C(2935411772) - (x * UINT64_C(2934109286)) / UINT64_C(2147483648); break;
-        case 123: offset = UINT64_C(2944920647) - (x * UINT64_C(2943996364)) / UINT64_C(2147483648); break;
-        case 124: offset = UINT64_C(2951351957) - (x * UINT64_C(2950630195)) / UINT64_C(2147483648); break;
-        case 125: offset = UINT64_C(2954562275) - (x * UINT64_C(2953916057)) / UINT64_C(2147483648); break;
-        case 126: offset = UINT64_C(2954404645) - (x * UINT64_C(2953757900)) / UINT64_C(2147483648); break;
-        case 127: offset = UINT64_C(2951425655) - (x * UINT64_C(2950758656)) / UINT64_C(2147483648); break;
-        default: offset = 0; break;
-        }
-        if (offset > x) {
-            offset = x;
-        }
-        return offset;
+        return intNd<3>(*this).valueRaw(x, y, z);
+    }
+
+    slice_t slice(const uint64_t z) const noexcept {
+        return intNd<3>(*this).slice(z);
     }
+    slab_t slab(const uint64_t x0, const uint64_t y0,
+            const uint32_t width, const uint32_t height, const uint64_t z0) const {
+        return intNd<3>(*this).slab(x0, y0, width, height, z0);
+    }
+
+    static uint32_t getOffsetU32(const uint32_t x) noexcept {
+        return intNd<3>::getOffsetU32(x);
+    }
+    static constexpr const auto& s_offsetLines = offset_table_t<3>::s_offsetLines;
 };
 
 struct int4d {
@@ -657,312 +2279,107 @@ struct int4d {
     uint32v4_t cellSize = { 64, 64, 64, 64 }; // 2..UINT32_MAX
     uint32_t seed = 0;
 
-    uint32_t value(const uint64_t x, const uint64_t y, const uint64_t z, const uint64_t w) const noexcept {
-        uint32_t s = valueShifted(x, y, z, w);
-        if (s < UINT32_MAX / 2) {
-            return s - getOffsetU32(s);
+    using prepared = intNd<4>::prepared;
+    using locality_t = intNd<4>::locality_t;
+    using slice_t = intNd<4>::slice_t;
+    using animation_t = intNd<4>::animation_t;
+
+    // The shift fields of the box [x0, x0 + width) x ... x [w0, w0 + length).
+    struct shifts : intNd<4>::shifts {
+        shifts() = default;
+        shifts(const uint32v4_t& cellSize,
+                const uint64_t x0, const uint64_t y0, const uint64_t z0, const uint64_t w0,
+                const uint32_t width, const uint32_t height, const uint32_t depth, const uint32_t length)
+            : intNd<4>::shifts({ cellSize.x, cellSize.y, cellSize.z, cellSize.w },
+                { x0, y0, z0, w0 }, { width, height, depth, length }) {
         }
-        s -= UINT32_MAX / 2;
-        s = UINT32_MAX / 2 - s;
-        s -= getOffsetU32(s);
-        s = UINT32_MAX / 2 - s;
-        s += UINT32_MAX / 2;
-        return s;
+    };
+
+    operator intNd<4>() const noexcept {
+        return intNd<4>({ cellSize.x, cellSize.y, cellSize.z, cellSize.w }, seed);
     }
 
+    uint32_t value(const uint64_t x, const uint64_t y, const uint64_t z, const uint64_t w) const noexcept {
+        return intNd<4>(*this).value(x, y, z, w);
+    }
+    // (x, y, z, w) inside the box of the shifts
+    uint32_t value(const uint64_t x, const uint64_t y, const uint64_t z, const uint64_t w,
+            const shifts& fields) const noexcept {
+        return intNd<4>(*this).value(x, y, z, w, fields);
+    }
     uint32_t valueShifted(const uint64_t x, const uint64_t y, const uint64_t z, const uint64_t w) const noexcept {
-        int1d n;
-        n.seed = 12;
-        n.cellSize = cellSize.x;
-        const uint32_t offset_x = utils::lerp_u32(n.value(x), UINT32_MAX, cellSize.x / 2);
-        n.seed = 34;
-        n.cellSize = cellSize.y;
-        const uint32_t offset_y = utils::lerp_u32(n.value(y), UINT32_MAX, cellSize.y / 2);
-        n.seed = 56;
-        n.cellSize = cellSize.z;
-        const uint32_t offset_z = utils::lerp_u32(n.value(z), UINT32_MAX, cellSize.z / 2);
-        n.seed = 78;
-        n.cellSize = cellSize.w;
-        const uint32_t offset_w = utils::lerp_u32(n.value(w), UINT32_MAX, cellSize.w / 2);
-        return valueRaw(x + offset_y, y + offset_z, z + offset_w, w + offset_x);
+        return intNd<4>(*this).valueShifted(x, y, z, w);
+    }
+    uint32_t valueShifted(const uint64_t x, const uint64_t y, const uint64_t z, const uint64_t w,
+            const shifts& fields) const noexcept {
+        return intNd<4>(*this).valueShifted(x, y, z, w, fields);
     }
-
     uint32_t valueRaw(const uint64_t x, const uint64_t y, const uint64_t z, const uint64_t w) const noexcept {
-        const uint64_t cellIdx_x = x / cellSize.x;
-        const uint64_t cellIdx_y = y / cellSize.y;
-        const uint64_t cellIdx_z = z / cellSize.z;
-        const uint64_t cellIdx_w = w / cellSize.w;
-        const uint64_t cell_x = cellIdx_x * cellSize.x;
-        const uint64_t cell_y = cellIdx_y * cellSize.y;
-        const uint64_t cell_z = cellIdx_z * cellSize.z;
-        const uint64_t cell_w = cellIdx_w * cellSize.w;
-        const uint64_t t_x = x - cell_x;
-        const uint64_t t_y = y - cell_y;
-        const uint64_t t_z = z - cell_z;
-        const uint64_t t_w = w - cell_w;
-        uint64_t seedSrc[4];
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z;
-        seedSrc[3] = cell_w;
-        const uint32_t seed0000 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z;
-        seedSrc[3] = cell_w;
-        const uint32_t seed0001 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z;
-        seedSrc[3] = cell_w;
-        const uint32_t seed0010 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z;
-        seedSrc[3] = cell_w;
-        const uint32_t seed0011 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z + cellSize.z;
-        seedSrc[3] = cell_w;
-        const uint32_t seed0100 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z + cellSize.z;
-        seedSrc[3] = cell_w;
-        const uint32_t seed0101 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z + cellSize.z;
-        seedSrc[3] = cell_w;
-        const uint32_t seed0110 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z + cellSize.z;
-        seedSrc[3] = cell_w;
-        const uint32_t seed0111 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z;
-        seedSrc[3] = cell_w + cellSize.w;
-        const uint32_t seed1000 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z;
-        seedSrc[3] = cell_w + cellSize.w;
-        const uint32_t seed1001 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z;
-        seedSrc[3] = cell_w + cellSize.w;
-        const uint32_t seed1010 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z;
-        seedSrc[3] = cell_w + cellSize.w;
-        const uint32_t seed1011 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z + cellSize.z;
-        seedSrc[3] = cell_w + cellSize.w;
-        const uint32_t seed1100 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y;
-        seedSrc[2] = cell_z + cellSize.z;
-        seedSrc[3] = cell_w + cellSize.w;
-        const uint32_t seed1101 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z + cellSize.z;
-        seedSrc[3] = cell_w + cellSize.w;
-        const uint32_t seed1110 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        seedSrc[0] = cell_x + cellSize.x;
-        seedSrc[1] = cell_y + cellSize.y;
-        seedSrc[2] = cell_z + cellSize.z;
-        seedSrc[3] = cell_w + cellSize.w;
-        const uint32_t seed1111 = utils::MurmurHash3_x32_32(seedSrc, sizeof(seedSrc), seed);
-
-        const uint32_t seed000 = utils::lerp_u32(t_x, cellSize.x - 1, seed0000, seed0001);
-        const uint32_t seed001 = utils::lerp_u32(t_x, cellSize.x - 1, seed0010, seed0011);
-        const uint32_t seed010 = utils::lerp_u32(t_x, cellSize.x - 1, seed0100, seed0101);
-        const uint32_t seed011 = utils::lerp_u32(t_x, cellSize.x - 1, seed0110, seed0111);
-        const uint32_t seed100 = utils::lerp_u32(t_x, cellSize.x - 1, seed1000, seed1001);
-        const uint32_t seed101 = utils::lerp_u32(t_x, cellSize.x - 1, seed1010, seed1011);
-        const uint32_t seed110 = utils::lerp_u32(t_x, cellSize.x - 1, seed1100, seed1101);
-        const uint32_t seed111 = utils::lerp_u32(t_x, cellSize.x - 1, seed1110, seed1111);
-
-        const uint32_t seed00 = utils::lerp_u32(t_y, cellSize.y - 1, seed000, seed001);
-        const uint32_t seed01 = utils::lerp_u32(t_y, cellSize.y - 1, seed010, seed011);
-        const uint32_t seed10 = utils::lerp_u32(t_y, cellSize.y - 1, seed100, seed101);
-        const uint32_t seed11 = utils::lerp_u32(t_y, cellSize.y - 1, seed110, seed111);
-
-        const uint32_t seed0 = utils::lerp_u32(t_z, cellSize.z - 1, seed00, seed01);
-        const uint32_t seed1 = utils::lerp_u32(t_z, cellSize.z - 1, seed10, seed11);
-
-        return utils::lerp_u32(t_w, cellSize.w - 1, seed0, seed1);
-    }
-
-    static uint32_t getOffsetU32(const uint32_t x_) noexcept {
-        if (x_ == 0) {
-            return 0;
-        }
-        constexpr uint32_t size = (UINT32_MAX / 2) / 128 + 1;
-        const uint64_t x = x_;
-        uint64_t offset = 0;
-        switch (x_ / size) {
-        case 0: offset = (x * UINT64_C(2105697178)) / UINT64_C(2147483648) - UINT64_C(210912); break;
-        case 1: offset = (x * UINT64_C(2159517900)) / UINT64_C(2147483648) - UINT64_C(525571); break;
-        case 2: offset = (x * UINT64_C(2158996787)) / UINT64_C(2147483648) - UINT64_C(516753); break;
-        case 3: offset = (x * UINT64_C(2158173388)) / UINT64_C(2147483648) - UINT64_C(496506); break;
-        case 4: offset = (x * UINT64_C(2157087692)) / UINT64_C(2147483648) - UINT64_C(461392); break;
-        case 5: offset = (x * UINT64_C(2155775232)) / UINT64_C(2147483648) - UINT64_C(408733); break;
-        case 6: offset = (x * UINT64_C(2154265241)) / UINT64_C(2147483648) - UINT64_C(336384); break;
-        case 7: offset = (x * UINT64_C(2152582963)) / UINT64_C(2147483648) - UINT64_C(242659); break;
-        case 8: offset = (x * UINT64_C(2150748416)) / UINT64_C(2147483648) - UINT64_C(126134); break;
-        case 9: offset = (x * UINT64_C(2148776550)) / UINT64_C(2147483648) + UINT64_C(14504); break;
-        case 10: offset = (x * UINT64_C(2146678220)) / UINT64_C(2147483648) + UINT64_C(180548); break;
-        case 11: offset = (x * UINT64_C(2144459980)) / UINT64_C(2147483648) + UINT64_C(373405); break;
-        case 12: offset = (x * UINT64_C(2142123468)) / UINT64_C(2147483648) + UINT64_C(594795); break;
-        case 13: offset = (x * UINT64_C(2139666534)) / UINT64_C(2147483648) + UINT64_C(846790); break;
-        case 14: offset = (x * UINT64_C(2137083494)) / UINT64_C(2147483648) + UINT64_C(1131899); break;
-        case 15: offset = (x * UINT64_C(2134363750)) / UINT64_C(2147483648) + UINT64_C(1453348); break;
-        case 16: offset = (x * UINT64_C(2131494400)) / UINT64_C(2147483648) + UINT64_C(1814899); break;
-        case 17: offset = (x * UINT64_C(2128457625)) / UINT64_C(2147483648) + UINT64_C(2221277); break;
-        case 18: offset = (x * UINT64_C(2125233100)) / UINT64_C(2147483648) + UINT64_C(2677976); break;
-        case 19: offset = (x * UINT64_C(2121797120)) / UINT64_C(2147483648) + UINT64_C(3191475); break;
-        case 20: offset = (x * UINT64_C(2118122547)) / UINT64_C(2147483648) + UINT64_C(3769345); break;
-        case 21: offset = (x * UINT64_C(2114179686)) / UINT64_C(2147483648) + UINT64_C(4420218); break;
-        case 22: offset = (x * UINT64_C(2109935974)) / UINT64_C(2147483648) + UINT64_C(5153913); break;
-        case 23: offset = (x * UINT64_C(2105355673)) / UINT64_C(2147483648) + UINT64_C(5981590); break;
-        case 24: offset = (x * UINT64_C(2100401152)) / UINT64_C(2147483648) + UINT64_C(6915602); break;
-        case 25: offset = (x * UINT64_C(2095032268)) / UINT64_C(2147483648) + UINT64_C(7969678); break;
-        case 26: offset = (x * UINT64_C(2089206476)) / UINT64_C(2147483648) + UINT64_C(9158977); break;
-        case 27: offset = (x * UINT64_C(2082879283)) / UINT64_C(2147483648) + UINT64_C(10500067); break;
-        case 28: offset = (x * UINT64_C(2076004249)) / UINT64_C(2147483648) + UINT64_C(12010987); break;
-        case 29: offset = (x * UINT64_C(2068533196)) / UINT64_C(2147483648) + UINT64_C(13711262); break;
-        case 30: offset = (x * UINT64_C(2060416409)) / UINT64_C(2147483648) + UINT64_C(15621905); break;
-        case 31: offset = (x * UINT64_C(2051602329)) / UINT64_C(2147483648) + UINT64_C(17765544); break;
-        case 32: offset = (x * UINT64_C(2042038579)) / UINT64_C(2147483648) + UINT64_C(20166219); break;
-        case 33: offset = (x * UINT64_C(2031671040)) / UINT64_C(2147483648) + UINT64_C(22849650); break;
-        case 34: offset = (x * UINT64_C(2020444876)) / UINT64_C(2147483648) + UINT64_C(25843018); break;
-        case 35: offset = (x * UINT64_C(2008304588)) / UINT64_C(2147483648) + UINT64_C(29174967); break;
-        case 36: offset = (x * UINT64_C(1995193446)) / UINT64_C(2147483648) + UINT64_C(32875791); break;
-        case 37: offset = (x * UINT64_C(1981054003)) / UINT64_C(2147483648) + UINT64_C(36977323); break;
-        case 38: offset = (x * UINT64_C(1965829273)) / UINT64_C(2147483648) + UINT64_C(41512604); break;
-        case 39: offset = (x * UINT64_C(1949460787)) / UINT64_C(2147483648) + UINT64_C(46516463); break;
-        case 40: offset = (x * UINT64_C(1931891097)) / UINT64_C(2147483648) + UINT64_C(52024780); break;
-        case 41: offset = (x * UINT64_C(1913061888)) / UINT64_C(2147483648) + UINT64_C(58075060); break;
-        case 42: offset = (x * UINT64_C(1892914790)) / UINT64_C(2147483648) + UINT64_C(64706191); break;
-        case 43: offset = (x * UINT64_C(1871392870)) / UINT64_C(2147483648) + UINT64_C(71957949); break;
-        case 44: offset = (x * UINT64_C(1848438681)) / UINT64_C(2147483648) + UINT64_C(79871616); break;
-        case 45: offset = (x * UINT64_C(1823995187)) / UINT64_C(2147483648) + UINT64_C(88489680); break;
-        case 46: offset = (x * UINT64_C(1798007040)) / UINT64_C(2147483648) + UINT64_C(97855356); break;
-        case 47: offset = (x * UINT64_C(1770418892)) / UINT64_C(2147483648) + UINT64_C(108013154); break;
-        case 48: offset = (x * UINT64_C(1741176627)) / UINT64_C(2147483648) + UINT64_C(119008421); break;
-        case 49: offset = (x * UINT64_C(1710227558)) / UINT64_C(2147483648) + UINT64_C(130887224); break;
-        case 50: offset = (x * UINT64_C(1677520076)) / UINT64_C(2147483648) + UINT64_C(143696439); break;
-        case 51: offset = (x * UINT64_C(1643004211)) / UINT64_C(2147483648) + UINT64_C(157483500); break;
-        case 52: offset = (x * UINT64_C(1606631116)) / UINT64_C(2147483648) + UINT64_C(172296555); break;
-        case 53: offset = (x * UINT64_C(1568354457)) / UINT64_C(2147483648) + UINT64_C(188183851); break;
-        case 54: offset = (x * UINT64_C(1528129126)) / UINT64_C(2147483648) + UINT64_C(205194206); break;
-        case 55: offset = (x * UINT64_C(1485912524)) / UINT64_C(2147483648) + UINT64_C(223376410); break;
-        case 56: offset = (x * UINT64_C(1441663897)) / UINT64_C(2147483648) + UINT64_C(242779447); break;
-        case 57: offset = (x * UINT64_C(1395344998)) / UINT64_C(2147483648) + UINT64_C(263452136); break;
-        case 58: offset = (x * UINT64_C(1346919987)) / UINT64_C(2147483648) + UINT64_C(285443097); break;
-        case 59: offset = (x * UINT64_C(1296355891)) / UINT64_C(2147483648) + UINT64_C(308800469); break;
-        case 60: offset = (x * UINT64_C(1243622195)) / UINT64_C(2147483648) + UINT64_C(333572006); break;
-        case 61: offset = (x * UINT64_C(1188691660)) / UINT64_C(2147483648) + UINT64_C(359804614); break;
-        case 62: offset = (x * UINT64_C(1131539660)) / UINT64_C(2147483648) + UINT64_C(387544572); break;
-        case 63: offset = (x * UINT64_C(1072145356)) / UINT64_C(2147483648) + UINT64_C(416836863); break;
-        case 64: offset = (x * UINT64_C(1010490828)) / UINT64_C(2147483648) + UINT64_C(447725500); break;
-        case 65: offset = (x * UINT64_C(946561689)) / UINT64_C(2147483648) + UINT64_C(480253116); break;
-        case 66: offset = (x * UINT64_C(880347648)) / UINT64_C(2147483648) + UINT64_C(514460567); break;
-        case 67: offset = (x * UINT64_C(811841689)) / UINT64_C(2147483648) + UINT64_C(550387231); break;
-        case 68: offset = (x * UINT64_C(741041152)) / UINT64_C(2147483648) + UINT64_C(588070335); break;
-        case 69: offset = (x * UINT64_C(667947366)) / UINT64_C(2147483648) + UINT64_C(627545010); break;
-        case 70: offset = (x * UINT64_C(592565555)) / UINT64_C(2147483648) + UINT64_C(668844223); break;
-        case 71: offset = (x * UINT64_C(514905856)) / UINT64_C(2147483648) + UINT64_C(711998091); break;
-        case 72: offset = (x * UINT64_C(434982860)) / UINT64_C(2147483648) + UINT64_C(757033982); break;
-        case 73: offset = (x * UINT64_C(352815616)) / UINT64_C(2147483648) + UINT64_C(803976375); break;
-        case 74: offset = (x * UINT64_C(268428083)) / UINT64_C(2147483648) + UINT64_C(852846459); break;
-        case 75: offset = (x * UINT64_C(181849446)) / UINT64_C(2147483648) + UINT64_C(903661793); break;
-        case 76: offset = (x * UINT64_C(93113651)) / UINT64_C(2147483648) + UINT64_C(956436424); break;
-        case 77: offset = (x * UINT64_C(2260172)) / UINT64_C(2147483648) + UINT64_C(1011180268); break;
-        case 78: offset = UINT64_C(1067898976) - (x * UINT64_C(90666035)) / UINT64_C(2147483648); break;
-        case 79: offset = UINT64_C(1126593848) - (x * UINT64_C(185614694)) / UINT64_C(2147483648); break;
-        case 80: offset = UINT64_C(1187261195) - (x * UINT64_C(282529433)) / UINT64_C(2147483648); break;
-        case 81: offset = UINT64_C(1249892698) - (x * UINT64_C(381348659)) / UINT64_C(2147483648); break;
-        case 82: offset = UINT64_C(1314474290) - (x * UINT64_C(482004070)) / UINT64_C(2147483648); break;
-        case 83: offset = UINT64_C(1380986579) - (x * UINT64_C(584421632)) / UINT64_C(2147483648); break;
-        case 84: offset = UINT64_C(1449403960) - (x * UINT64_C(688520499)) / UINT64_C(2147483648); break;
-        case 85: offset = UINT64_C(1519695090) - (x * UINT64_C(794214041)) / UINT64_C(2147483648); break;
-        case 86: offset = UINT64_C(1591821836) - (x * UINT64_C(901408563)) / UINT64_C(2147483648); break;
-        case 87: offset = UINT64_C(1665739412) - (x * UINT64_C(1010003814)) / UINT64_C(2147483648); break;
-        case 88: offset = UINT64_C(1741395888) - (x * UINT64_C(1119892582)) / UINT64_C(2147483648); break;
-        case 89: offset = UINT64_C(1818731828) - (x * UINT64_C(1230960486)) / UINT64_C(2147483648); break;
-        case 90: offset = UINT64_C(1897680359) - (x * UINT64_C(1343086387)) / UINT64_C(2147483648); break;
-        case 91: offset = UINT64_C(1978166119) - (x * UINT64_C(1456141209)) / UINT64_C(2147483648); break;
-        case 92: offset = UINT64_C(2060105633) - (x * UINT64_C(1569988812)) / UINT64_C(2147483648); break;
-        case 93: offset = UINT64_C(2143406687) - (x * UINT64_C(1684485427)) / UINT64_C(2147483648); break;
-        case 94: offset = UINT64_C(2227967409) - (x * UINT64_C(1799478732)) / UINT64_C(2147483648); break;
-        case 95: offset = UINT64_C(2313677637) - (x * UINT64_C(1914810060)) / UINT64_C(2147483648); break;
-        case 96: offset = UINT64_C(2400416266) - (x * UINT64_C(2030311116)) / UINT64_C(2147483648); break;
-        case 97: offset = UINT64_C(2488052376) - (x * UINT64_C(2145805875)) / UINT64_C(2147483648); break;
-        case 98: offset = UINT64_C(2576444956) - (x * UINT64_C(2261110528)) / UINT64_C(2147483648); break;
-        case 99: offset = UINT64_C(2665441593) - (x * UINT64_C(2376032102)) / UINT64_C(2147483648); break;
-        case 100: offset = UINT64_C(2754878577) - (x * UINT64_C(2490368972)) / UINT64_C(2147483648); break;
-        case 101: offset = UINT64_C(2844580803) - (x * UINT64_C(2603911065)) / UINT64_C(2147483648); break;
-        case 102: offset = UINT64_C(2934360846) - (x * UINT64_C(2716439040)) / UINT64_C(2147483648); break;
-        case 103: offset = UINT64_C(3024018963) - (x * UINT64_C(2827724646)) / UINT64_C(2147483648); break;
-        case 104: offset = UINT64_C(3113342523) - (x * UINT64_C(2937530368)) / UINT64_C(2147483648); break;
-        case 105: offset = UINT64_C(3202105254) - (x * UINT64_C(3045608857)) / UINT64_C(2147483648); break;
-        case 106: offset = UINT64_C(3290067955) - (x * UINT64_C(3151704166)) / UINT64_C(2147483648); break;
-        case 107: offset = UINT64_C(3376976687) - (x * UINT64_C(3255549900)) / UINT64_C(2147483648); break;
-        case 108: offset = UINT64_C(3462562832) - (x * UINT64_C(3356869683)) / UINT64_C(2147483648); break;
-        case 109: offset = UINT64_C(3546543261) - (x * UINT64_C(3455377715)) / UINT64_C(2147483648); break;
-        case 110: offset = UINT64_C(3628619382) - (x * UINT64_C(3550778009)) / UINT64_C(2147483648); break;
-        case 111: offset = UINT64_C(3708476244) - (x * UINT64_C(3642763724)) / UINT64_C(2147483648); break;
-        case 112: offset = UINT64_C(3785783224) - (x * UINT64_C(3731018342)) / UINT64_C(2147483648); break;
-        case 113: offset = UINT64_C(3860192421) - (x * UINT64_C(3815214182)) / UINT64_C(2147483648); break;
-        case 114: offset = UINT64_C(3931339027) - (x * UINT64_C(3895013222)) / UINT64_C(2147483648); break;
-        case 115: offset = UINT64_C(3998840138) - (x * UINT64_C(3970066124)) / UINT64_C(2147483648); break;
-        case 116: offset = UINT64_C(4062295372) - (x * UINT64_C(4040013312)) / UINT64_C(2147483648); break;
-        case 117: offset = UINT64_C(4121285143) - (x * UINT64_C(4104483430)) / UINT64_C(2147483648); break;
-        case 118: offset = UINT64_C(4175370627) - (x * UINT64_C(4163093708)) / UINT64_C(2147483648); break;
-        case 119: offset = UINT64_C(4224093589) - (x * UINT64_C(4215450163)) / UINT64_C(2147483648); break;
-        case 120: offset = UINT64_C(4266975846) - (x * UINT64_C(4261147392)) / UINT64_C(2147483648); break;
-        case 121: offset = UINT64_C(4303518622) - (x * UINT64_C(4299768268)) / UINT64_C(2147483648); break;
-        case 122: offset = UINT64_C(4333201345) - (x * UINT64_C(4330883072)) / UINT64_C(2147483648); break;
-        case 123: offset = UINT64_C(4355482682) - (x * UINT64_C(4354050969)) / UINT64_C(2147483648); break;
-        case 124: offset = UINT64_C(4369798260) - (x * UINT64_C(4368818022)) / UINT64_C(2147483648); break;
-        case 125: offset = UINT64_C(4375561855) - (x * UINT64_C(4374718822)) / UINT64_C(2147483648); break;
-        case 126: offset = UINT64_C(4372163621) - (x * UINT64_C(4371275059)) / UINT64_C(2147483648); break;
-        case 127: offset = UINT64_C(4361286635) - (x * UINT64_C(4360323072)) / UINT64_C(2147483648); break;
-        default: offset = 0; break;
-        }
-        if (offset > x) {
-            offset = x;
-        }
-        return offset;
+        return intNd<4>(*this).valueRaw(x, y, z, w);
+    }
+
+    slice_t slice(const uint64_t z, const uint64_t w) const noexcept {
+        return intNd<4>(*this).slice(z, w);
+    }
+    animation_t animation(const uint64_t x0, const uint64_t y0,
+            const uint32_t width, const uint32_t height, const uint64_t z) const {
+        return intNd<4>(*this).animation(x0, y0, width, height, z);
+    }
+
+    static uint32_t getOffsetU32(const uint32_t x) noexcept {
+        return intNd<4>::getOffsetU32(x);
+    }
+    static constexpr const auto& s_offsetLines = offset_table_t<4>::s_offsetLines;
+};
+
+// intNd with compile-time cell sizes and seed: the same values as intNd with
+// the same parameters, while the divisions by cellSize and cellSize - 1 fold
+// into constants (shifts and masks for powers of two).
+template <uint32_t seed_, uint32_t... cellSize_>
+struct basic_intNd {
+    static constexpr uint32_t N = sizeof...(cellSize_);
+    static_assert(((cellSize_ >= 2) && ...), "cellSize must be 2..UINT32_MAX");
+    static constexpr uint32_t cellSize[N] = { cellSize_... };
+    static constexpr uint32_t seed = seed_;
+
+    template <typename... args_t> requires detail::coordinates<N, args_t...>
+    uint32_t value(const args_t&... args) const noexcept {
+        return detail::unpack<N>([this](const auto&... a) { return value(a...); }, args...);
+    }
+    uint32_t value(const uint64_t (&p)[N]) const noexcept {
+        return detail::value<N>(cells_t(), seed, p);
+    }
+
+    template <typename... args_t> requires detail::coordinates<N, args_t...>
+    uint32_t valueShifted(const args_t&... args) const noexcept {
+        return detail::unpack<N>([this](const auto&... a) { return valueShifted(a...); }, args...);
+    }
+    uint32_t valueShifted(const uint64_t (&p)[N]) const noexcept {
+        return detail::valueShifted<N>(cells_t(), seed, p);
     }
+
+    template <typename... args_t> requires detail::coordinates<N, args_t...>
+    uint32_t valueRaw(const args_t&... args) const noexcept {
+        return detail::unpack<N>([this](const auto&... a) { return valueRaw(a...); }, args...);
+    }
+    uint32_t valueRaw(const uint64_t (&p)[N]) const noexcept {
+        return detail::valueRaw<N>(cells_t(), seed, p);
+    }
+
+private:
+    using cells_t = detail::fixed_cells_t<cellSize_...>;
 };
 
+template <uint32_t cellSize, uint32_t seed = 0>
+using basic_int1d = basic_intNd<seed, cellSize>;
+template <uint32_t cellSize_x, uint32_t cellSize_y, uint32_t seed = 0>
+using basic_int2d = basic_intNd<seed, cellSize_x, cellSize_y>;
+template <uint32_t cellSize_x, uint32_t cellSize_y, uint32_t cellSize_z, uint32_t seed = 0>
+using basic_int3d = basic_intNd<seed, cellSize_x, cellSize_y, cellSize_z>;
+template <uint32_t cellSize_x, uint32_t cellSize_y, uint32_t cellSize_z, uint32_t cellSize_w,
+    uint32_t seed = 0>
+using basic_int4d = basic_intNd<seed, cellSize_x, cellSize_y, cellSize_z, cellSize_w>;
+
 } // namespace noise
 
 #endif // SIMPLE_UNIFORM_NOISE
@@ -0,0 +1,272 @@
+// Simple Uniform Noise
+//
+// Author: Yurii Blok
+// License: BSL-1.0
+// https://github.com/yurablok/simple-uniform-noise
+// History:
+// v0.1 2023-Jan-29     First release.
+
+#pragma once
+#ifndef SIMPLE_UNIFORM_NOISE_PARALLEL
+#define SIMPLE_UNIFORM_NOISE_PARALLEL
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "noise.hpp"
+
+namespace noise {
+
+// Fixed-size pool with one task deque per worker. A worker takes tasks from
+// the front of its own deque and steals from the back of the others' deques.
+// The thread calling run() works as worker 0. run() calls from different
+// threads are serialized; calling run() from inside a task deadlocks.
+class thread_pool {
+public:
+    // threads: total number of workers including the caller, 0 = all cores.
+    explicit thread_pool(uint32_t threads = 0) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        m_queues = std::vector<queue_t>(threads);
+        m_threads.reserve(threads - 1);
+        for (uint32_t idx = 1; idx < threads; ++idx) {
+            m_threads.emplace_back([this, idx] { workerLoop(idx); });
+        }
+    }
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    uint32_t size() const noexcept {
+        return static_cast<uint32_t>(m_queues.size());
+    }
+
+    // Calls func(idx) for every idx in [0, count) and waits for completion.
+    // func must not throw.
+    template <typename func_t>
+    void run(const size_t count, func_t&& func) {
+        if (count == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> runLock(m_runMutex);
+        job_t job;
+        job.context = &func;
+        job.invoke = [](void* context, const size_t idx) {
+            (*static_cast<std::remove_reference_t<func_t>*>(context))(idx);
+        };
+        job.pending = count;
+        // Contiguous chunks keep neighbouring tiles on the same worker.
+        const size_t workers = m_queues.size();
+        for (size_t worker = 0; worker < workers; ++worker) {
+            const size_t begin = count * worker / workers;
+            const size_t end = count * (worker + 1) / workers;
+            std::lock_guard<std::mutex> lock(m_queues[worker].mutex);
+            for (size_t idx = begin; idx < end; ++idx) {
+                m_queues[worker].tasks.emplace_back(&job, idx);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        execute(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&job] { return job.pending.load() == 0; });
+    }
+
+    // Process-wide pool with one worker per core.
+    static thread_pool& shared() {
+        static thread_pool pool;
+        return pool;
+    }
+
+private:
+    struct job_t {
+        void* context = nullptr;
+        void (*invoke)(void* context, size_t idx) = nullptr;
+        std::atomic<size_t> pending = 0;
+    };
+    using task_t = std::pair<job_t*, size_t>;
+    struct queue_t {
+        std::mutex mutex;
+        std::deque<task_t> tasks;
+    };
+
+    bool pop(const size_t worker, task_t& task) {
+        {
+            queue_t& own = m_queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = own.tasks.front();
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < m_queues.size(); ++i) {
+            queue_t& victim = m_queues[(worker + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+    void execute(const size_t worker) {
+        task_t task;
+        while (pop(worker, task)) {
+            job_t& job = *task.first;
+            job.invoke(job.context, task.second);
+            if (--job.pending == 0) {
+                // Under the lock so that run() cannot miss the notification.
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done.notify_all();
+            }
+        }
+    }
+    void workerLoop(const size_t worker) {
+        uint64_t generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+                if (m_stop) {
+                    return;
+                }
+                generation = m_generation;
+            }
+            execute(worker);
+        }
+    }
+
+    std::vector<queue_t> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_runMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t m_generation = 0;
+    bool m_stop = false;
+};
+
+namespace detail {
+    // 64x64 uint32_t = 16 KiB of output per tile.
+    constexpr uint32_t g_tileSize = 64;
+
+    inline uint32_t tileCount(const uint32_t size) noexcept {
+        return size / g_tileSize + (size % g_tileSize != 0);
+    }
+} // namespace detail
+
+// Every output element is computed independently of the tiling, so the
+// result is the same as the serial fill for any number of threads.
+
+// out[row * stride + col] = noise.value(x0 + col, y0 + row)
+inline void parallel_fill(thread_pool& pool, const int2d& noise,
+        const uint64_t x0, const uint64_t y0,
+        const uint32_t width, const uint32_t height,
+        uint32_t* out, const size_t stride) {
+    const uint32_t tiles_x = detail::tileCount(width);
+    const uint32_t tiles_y = detail::tileCount(height);
+    pool.run(size_t(tiles_x) * tiles_y, [&](const size_t idx) {
+        const uint32_t col = static_cast<uint32_t>(idx % tiles_x) * detail::g_tileSize;
+        const uint32_t row = static_cast<uint32_t>(idx / tiles_x) * detail::g_tileSize;
+        noise.fill(x0 + col, y0 + row,
+            std::min(detail::g_tileSize, width - col),
+            std::min(detail::g_tileSize, height - row),
+            out + row * stride + col, stride);
+    });
+}
+inline void parallel_fill(const int2d& noise,
+        const uint64_t x0, const uint64_t y0,
+        const uint32_t width, const uint32_t height,
+        uint32_t* out, const size_t stride) {
+    parallel_fill(thread_pool::shared(), noise, x0, y0, width, height, out, stride);
+}
+
+// out[slice * stride_z + row * stride_y + col] = noise.value(x0 + col, y0 + row, z0 + slice)
+inline void parallel_fill(thread_pool& pool, const int3d& noise,
+        const uint64_t x0, const uint64_t y0, const uint64_t z0,
+        const uint32_t width, const uint32_t height, const uint32_t depth,
+        uint32_t* out, const size_t stride_y, const size_t stride_z) {
+    std::vector<int3d::slice_t> slices;
+    slices.reserve(depth);
+    for (uint32_t slice = 0; slice < depth; ++slice) {
+        slices.push_back(noise.slice(z0 + slice));
+    }
+    const uint32_t tiles_x = detail::tileCount(width);
+    const uint32_t tiles_y = detail::tileCount(height);
+    const size_t tiles = size_t(tiles_x) * tiles_y;
+    pool.run(tiles * depth, [&](const size_t idx) {
+        const uint32_t slice = static_cast<uint32_t>(idx / tiles);
+        const uint32_t col = static_cast<uint32_t>(idx % tiles % tiles_x) * detail::g_tileSize;
+        const uint32_t row = static_cast<uint32_t>(idx % tiles / tiles_x) * detail::g_tileSize;
+        slices[slice].fill(x0 + col, y0 + row,
+            std::min(detail::g_tileSize, width - col),
+            std::min(detail::g_tileSize, height - row),
+            out + slice * stride_z + row * stride_y + col, stride_y);
+    });
+}
+inline void parallel_fill(const int3d& noise,
+        const uint64_t x0, const uint64_t y0, const uint64_t z0,
+        const uint32_t width, const uint32_t height, const uint32_t depth,
+        uint32_t* out, const size_t stride_y, const size_t stride_z) {
+    parallel_fill(thread_pool::shared(), noise, x0, y0, z0,
+        width, height, depth, out, stride_y, stride_z);
+}
+
+// out[frame * stride_w + slice * stride_z + row * stride_y + col]
+//     = noise.value(x0 + col, y0 + row, z0 + slice, w0 + frame)
+inline void parallel_fill(thread_pool& pool, const int4d& noise,
+        const uint64_t x0, const uint64_t y0, const uint64_t z0, const uint64_t w0,
+        const uint32_t width, const uint32_t height, const uint32_t depth, const uint32_t length,
+        uint32_t* out, const size_t stride_y, const size_t stride_z, const size_t stride_w) {
+    // Slice (z0 + slice, w0 + frame) is slices[frame * depth + slice].
+    std::vector<int4d::slice_t> slices;
+    slices.reserve(size_t(depth) * length);
+    for (uint32_t frame = 0; frame < length; ++frame) {
+        for (uint32_t slice = 0; slice < depth; ++slice) {
+            slices.push_back(noise.slice(z0 + slice, w0 + frame));
+        }
+    }
+    const uint32_t tiles_x = detail::tileCount(width);
+    const uint32_t tiles_y = detail::tileCount(height);
+    const size_t tiles = size_t(tiles_x) * tiles_y;
+    pool.run(tiles * depth * length, [&](const size_t idx) {
+        const uint32_t frame = static_cast<uint32_t>(idx / tiles / depth);
+        const uint32_t slice = static_cast<uint32_t>(idx / tiles % depth);
+        const uint32_t col = static_cast<uint32_t>(idx % tiles % tiles_x) * detail::g_tileSize;
+        const uint32_t row = static_cast<uint32_t>(idx % tiles / tiles_x) * detail::g_tileSize;
+        slices[idx / tiles].fill(x0 + col, y0 + row,
+            std::min(detail::g_tileSize, width - col),
+            std::min(detail::g_tileSize, height - row),
+            out + frame * stride_w + slice * stride_z + row * stride_y + col, stride_y);
+    });
+}
+inline void parallel_fill(const int4d& noise,
+        const uint64_t x0, const uint64_t y0, const uint64_t z0, const uint64_t w0,
+        const uint32_t width, const uint32_t height, const uint32_t depth, const uint32_t length,
+        uint32_t* out, const size_t stride_y, const size_t stride_z, const size_t stride_w) {
+    parallel_fill(thread_pool::shared(), noise, x0, y0, z0, w0,
+        width, height, depth, length, out, stride_y, stride_z, stride_w);
+}
+
+} // namespace noise
+
+#endif // SIMPLE_UNIFORM_NOISE_PARALLEL
@@ -1,17 +1,69 @@
 #pragma once
 #ifndef SIMPLE_UNIFORM_NOISE_POLYFIT
 #define SIMPLE_UNIFORM_NOISE_POLYFIT
+#include <algorithm>
 #include <cmath>
 #include <array>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
 
 namespace utils {
 
+// Immutable polynomial, e.g. a snapshot of a Polyfit, safe to evaluate
+// from any number of threads.
+template <typename value_t, uint8_t degree>
+class Polynomial {
+    static constexpr size_t s_rows = degree + 1;
+public:
+    Polynomial() = default;
+    explicit Polynomial(const std::array<value_t, s_rows>& weights)
+        : m_weights(weights) {
+    }
+    const std::array<value_t, s_rows>& weights() const {
+        return m_weights;
+    }
+    value_t y(const value_t x) const {
+        intptr_t i = s_rows - 1;
+        value_t y = m_weights[i];
+        while (i-- > 0) {
+            y = y * x + m_weights[i];
+        }
+        return y;
+    }
+    // ys[i] = y(xs[i]), ys.size() >= xs.size()
+    void y(std::span<const value_t> xs, std::span<value_t> ys) const {
+        size_t idx = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<value_t, double>) {
+            for (; idx + 4 <= xs.size(); idx += 4) {
+                const __m256d x = _mm256_loadu_pd(xs.data() + idx);
+                __m256d y = _mm256_set1_pd(m_weights[s_rows - 1]);
+                for (intptr_t i = s_rows - 2; i >= 0; --i) {
+                    y = _mm256_add_pd(_mm256_mul_pd(y, x), _mm256_set1_pd(m_weights[i]));
+                }
+                _mm256_storeu_pd(ys.data() + idx, y);
+            }
+        }
+#endif
+        for (; idx < xs.size(); ++idx) {
+            ys[idx] = y(xs[idx]);
+        }
+    }
+private:
+    std::array<value_t, s_rows> m_weights = {};
+};
+
 // https://github.com/splicer/polyfit
 // polyfit uses recursive least squares to perform a polynomial regression
 // (i.e. it fits a polynomial to a set of data points without requiring a large buffer).
 // For details on the math behind this recursive least squares implementation, see
 // Gentlemen & Kung's famous 1981 paper "Matrix triangularization by systolic arrays".
+// The const methods do not modify the state, so concurrent readers are safe.
 template <typename value_t, uint8_t degree>
 class Polyfit {
     static constexpr value_t s_smallValue = 1.0E-32;
@@ -32,8 +84,47 @@ public:
             in[j] = in[j - 1] * x;
         }
         in[s_cols - 1] = y;
-
+        rotate(in, 0);
+    }
+    // xs.size() == ys.size()
+    void add(std::span<const value_t> xs, std::span<const value_t> ys) {
+        for (size_t idx = 0; idx < xs.size(); ++idx) {
+            add(xs[idx], ys[idx]);
+        }
+    }
+    // Adds the points of the other fit, e.g. of a per-thread shard. The
+    // triangular rows of the other fit are rotated in as observations.
+    void merge(const Polyfit& other) {
         for (size_t i = 0; i < s_rows; ++i) {
+            std::array<value_t, s_cols> in = {};
+            for (size_t j = i; j < s_cols; ++j) {
+                in[j] = other.m_cells[i * s_cols + j];
+            }
+            rotate(in, i);
+        }
+    }
+    Polynomial<value_t, degree> polynomial() const {
+        std::array<value_t, s_rows> weights;
+        for (intptr_t i = s_rows - 1; i >= 0; --i) {
+            weights[i] = m_cells[i * s_cols + s_cols - 1];
+            for (size_t j = i + 1; j < s_cols - 1; j++) {
+                weights[i] -= m_cells[i * s_cols + j] * weights[j];
+            }
+            weights[i] /= m_cells[i * s_cols + i];
+        }
+        return Polynomial<value_t, degree>(weights);
+    }
+    std::array<value_t, s_rows> weights() const {
+        return polynomial().weights();
+    }
+    // Solves the weights on every call, use polynomial() for many points.
+    value_t y(const value_t x) const {
+        return polynomial().y(x);
+    }
+private:
+    // in[0, first) must be zero
+    void rotate(std::array<value_t, s_cols>& in, const size_t first) {
+        for (size_t i = first; i < s_rows; ++i) {
             value_t c;
             value_t s;
             boundaryCell(m_cells[i * s_cols + i], c, s, in[i]);
@@ -44,22 +135,7 @@ public:
                 }
             }
         }
-        m_weightsNeedUpdate = true;
-    }
-    const std::array<value_t, s_rows>& weights() const {
-        computeWeights();
-        return m_weights;
     }
-    value_t y(const value_t x) const {
-        computeWeights();
-        intptr_t i = s_rows - 1;
-        value_t y = m_weights[i];
-        while (i-- > 0) {
-            y = y * x + m_weights[i];
-        }
-        return y;
-    }
-private:
     // givens generation
     static void boundaryCell(value_t& cell, value_t& c, value_t& s, value_t in) {
         if (std::abs(in) < s_smallValue) {
@@ -80,25 +156,11 @@ private:
         cell = s * in + s_forgettingFactor * c * cell;
         return out;
     }
-    void computeWeights() const {
-        if (!m_weightsNeedUpdate) {
-            return;
-        }
-        for (intptr_t i = s_rows - 1; i >= 0; --i) {
-            m_weights[i] = m_cells[i * s_cols + s_cols - 1];
-            for (size_t j = i + 1; j < s_cols - 1; j++) {
-                m_weights[i] -= m_cells[i * s_cols + j] * m_weights[j];
-            }
-            m_weights[i] /= m_cells[i * s_cols + i];
-        }
-        m_weightsNeedUpdate = false;
-    }
 
     std::array<value_t, s_rows * s_cols> m_cells;
-    mutable std::array<value_t, s_rows> m_weights;
-    mutable bool m_weightsNeedUpdate = false;
 };
 
+// Polyfit with the degree chosen at run time.
 class PolyfitD {
     static constexpr double m_smallValue = 1.0E-32;
     static constexpr double m_forgettingFactor = 1.0 - 1.0E-11;
@@ -111,9 +173,6 @@ public:
         m_cells.clear();
         m_cells.resize(m_rows * m_cols, m_smallValue);
 
-        m_weights.clear();
-        m_weights.resize(m_rows);
-
         m_in.resize(m_cols);
     }
     void add(const value_t x, const value_t y) {
@@ -122,34 +181,59 @@ public:
             m_in[j] = m_in[j - 1] * x;
         }
         m_in[m_cols - 1] = y;
-
+        rotate(0);
+    }
+    // xs.size() == ys.size()
+    void add(std::span<const value_t> xs, std::span<const value_t> ys) {
+        for (size_t idx = 0; idx < xs.size(); ++idx) {
+            add(xs[idx], ys[idx]);
+        }
+    }
+    // The other fit must be created with the same degree.
+    void merge(const PolyfitD& other) {
         for (size_t i = 0; i < m_rows; ++i) {
-            value_t c;
-            value_t s;
-            boundaryCell(m_cells[i * m_cols + i], c, s, m_in[i]);
-            for (size_t j = i + 1; j < m_cols; ++j) {
-                value_t out = internalCell(m_cells[i * m_cols + j], c, s, m_in[j]);
-                if (i < m_rows - 1) {
-                    m_in[j] = out;
-                }
+            for (size_t j = 0; j < m_cols; ++j) {
+                m_in[j] = j < i ? 0.0 : other.m_cells[i * m_cols + j];
             }
+            rotate(i);
         }
-        m_weightsNeedUpdate = true;
     }
-    const std::vector<value_t>& weights() const {
-        computeWeights();
-        return m_weights;
+    std::vector<value_t> weights() const {
+        std::vector<value_t> weights(m_rows);
+        for (intptr_t i = m_rows - 1; i >= 0; --i) {
+            weights[i] = m_cells[i * m_cols + m_cols - 1];
+            for (size_t j = i + 1; j < m_cols - 1; j++) {
+                weights[i] -= m_cells[i * m_cols + j] * weights[j];
+            }
+            weights[i] /= m_cells[i * m_cols + i];
+        }
+        return weights;
     }
+    // Solves the weights on every call.
     value_t y(const value_t x) const {
-        computeWeights();
+        const std::vector<value_t> weights = this->weights();
         intptr_t i = m_rows - 1;
-        value_t y = m_weights[i];
+        value_t y = weights[i];
         while (i-- > 0) {
-            y = y * x + m_weights[i];
+            y = y * x + weights[i];
         }
         return y;
     }
 private:
+    // m_in[0, first) must be zero
+    void rotate(const size_t first) {
+        for (size_t i = first; i < m_rows; ++i) {
+            value_t c;
+            value_t s;
+            boundaryCell(m_cells[i * m_cols + i], c, s, m_in[i]);
+            for (size_t j = i + 1; j < m_cols; ++j) {
+                value_t out = internalCell(m_cells[i * m_cols + j], c, s, m_in[j]);
+                if (i < m_rows - 1) {
+                    m_in[j] = out;
+                }
+            }
+        }
+    }
     // givens generation
     static void boundaryCell(value_t& cell, value_t& c, value_t& s, value_t in) {
         if (std::abs(in) < m_smallValue) {
@@ -170,26 +254,144 @@ private:
         cell = s * in + m_forgettingFactor * c * cell;
         return out;
     }
-    void computeWeights() const {
-        if (!m_weightsNeedUpdate) {
-            return;
-        }
-        for (intptr_t i = m_rows - 1; i >= 0; --i) {
-            m_weights[i] = m_cells[i * m_cols + m_cols - 1];
-            for (size_t j = i + 1; j < m_cols - 1; j++) {
-                m_weights[i] -= m_cells[i * m_cols + j] * m_weights[j];
-            }
-            m_weights[i] /= m_cells[i * m_cols + i];
-        }
-        m_weightsNeedUpdate = false;
-    }
 
     std::vector<value_t> m_cells;
-    mutable std::vector<value_t> m_weights;
     std::vector<value_t> m_in;
     size_t m_rows = 0;
     size_t m_cols = 0;
-    mutable bool m_weightsNeedUpdate = false;
+};
+
+// Least-squares lines over fixed segments [knots[i], knots[i + 1]) from
+// O(1) running sums per segment, so any number of segments is fitted in
+// one pass over the points. Fitters filled by different threads over the
+// same knots are combined with merge(). x is stored relative to the
+// segment start to keep the sums well-conditioned for large x.
+template <typename value_t>
+class SegmentedLinefit {
+public:
+    // y = slope * x + intercept
+    struct line_t {
+        value_t slope = 0;
+        value_t intercept = 0;
+    };
+
+    SegmentedLinefit() = default;
+    // knots: ascending segment bounds, segments() == knots.size() - 1.
+    explicit SegmentedLinefit(std::vector<value_t> knots)
+        : m_knots(std::move(knots)), m_sums(m_knots.size() - 1) {
+    }
+    void reset() {
+        std::fill(m_sums.begin(), m_sums.end(), sums_t());
+    }
+    size_t segments() const {
+        return m_sums.size();
+    }
+    const std::vector<value_t>& knots() const {
+        return m_knots;
+    }
+    // The segment containing x, points outside the knots go to the edge segments.
+    size_t segment(const value_t x) const {
+        const auto it = std::upper_bound(m_knots.begin() + 1, m_knots.end() - 1, x);
+        return static_cast<size_t>(it - m_knots.begin()) - 1;
+    }
+    void add(const value_t x, const value_t y) {
+        add(segment(x), x, y);
+    }
+    void add(const size_t segment, const value_t x, const value_t y) {
+        sums_t& sums = m_sums[segment];
+        const value_t dx = x - m_knots[segment];
+        sums.n += 1;
+        sums.x += dx;
+        sums.y += y;
+        sums.xx += dx * dx;
+        sums.xy += dx * y;
+    }
+    void merge(const SegmentedLinefit& other) {
+        for (size_t i = 0; i < m_sums.size(); ++i) {
+            m_sums[i].n += other.m_sums[i].n;
+            m_sums[i].x += other.m_sums[i].x;
+            m_sums[i].y += other.m_sums[i].y;
+            m_sums[i].xx += other.m_sums[i].xx;
+            m_sums[i].xy += other.m_sums[i].xy;
+        }
+    }
+
+    // Every segment fitted on its own. A segment without points gets a zero
+    // line, a segment with a single distinct x a horizontal one.
+    std::vector<line_t> lines() const {
+        std::vector<line_t> lines(m_sums.size());
+        for (size_t i = 0; i < m_sums.size(); ++i) {
+            const sums_t& s = m_sums[i];
+            if (s.n == 0) {
+                continue;
+            }
+            const value_t det = s.n * s.xx - s.x * s.x;
+            const value_t slope = det > 0 ? (s.n * s.xy - s.x * s.y) / det : 0;
+            lines[i].slope = slope;
+            lines[i].intercept = (s.y - slope * s.x) / s.n - slope * m_knots[i];
+        }
+        return lines;
+    }
+
+    // The lines constrained to meet at the knots: the least-squares fit of
+    // the values at the knots, a tridiagonal system. A knot without points
+    // in both adjacent segments gets the value 0.
+    std::vector<line_t> continuousLines() const {
+        const size_t knots = m_knots.size();
+        std::vector<value_t> diag(knots, 0);
+        std::vector<value_t> upper(knots, 0);
+        std::vector<value_t> values(knots, 0);
+        for (size_t i = 0; i < m_sums.size(); ++i) {
+            // u = dx / h, the weights of the knots are 1 - u and u
+            const sums_t& s = m_sums[i];
+            const value_t h = m_knots[i + 1] - m_knots[i];
+            const value_t su = s.x / h;
+            const value_t suu = s.xx / (h * h);
+            const value_t suy = s.xy / h;
+            diag[i] += s.n - 2 * su + suu;
+            diag[i + 1] += suu;
+            upper[i] += su - suu;
+            values[i] += s.y - suy;
+            values[i + 1] += suy;
+        }
+        // Thomas algorithm, the matrix is symmetric
+        for (size_t i = 0; i < knots; ++i) {
+            if (i > 0 && diag[i - 1] > 0) {
+                const value_t factor = upper[i - 1] / diag[i - 1];
+                diag[i] -= factor * upper[i - 1];
+                values[i] -= factor * values[i - 1];
+            }
+        }
+        for (size_t i = knots; i-- > 0;) {
+            if (diag[i] <= 0) {
+                values[i] = 0;
+                continue;
+            }
+            if (i + 1 < knots) {
+                values[i] -= upper[i] * values[i + 1];
+            }
+            values[i] /= diag[i];
+        }
+        std::vector<line_t> lines(m_sums.size());
+        for (size_t i = 0; i < m_sums.size(); ++i) {
+            const value_t slope = (values[i + 1] - values[i]) / (m_knots[i + 1] - m_knots[i]);
+            lines[i].slope = slope;
+            lines[i].intercept = values[i] - slope * m_knots[i];
+        }
+        return lines;
+    }
+
+private:
+    struct sums_t {
+        value_t n = 0;
+        value_t x = 0;
+        value_t y = 0;
+        value_t xx = 0;
+        value_t xy = 0;
+    };
+
+    std::vector<value_t> m_knots;
+    std::vector<sums_t> m_sums;
 };
 
 } // namespace utils
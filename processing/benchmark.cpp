@@ -0,0 +1,634 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../calibration.hpp"
+#include "../noise.hpp"
+#include "../parallel.hpp"
+
+namespace {
+    uint32_t g_reps = 10'000'000;
+    volatile uint32_t g_sink = 0;
+    volatile uint32_t g_cellSize = 64; // Not a compile-time constant
+    bool g_json = false;
+
+    struct result_t {
+        std::string name;
+        uint32_t cellSize = 0; // 0 if not applicable
+        const char* pattern = "";
+        double ns = 0.0; // Per sample
+    };
+    std::vector<result_t> g_results;
+} // namespace
+
+namespace legacy {
+
+// MurmurHash3_x32_32 as it was built by GCC before the fixed-arity overloads,
+// i.e. with the SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND -O0 pragma.
+#ifdef __GNUG__
+# pragma GCC push_options
+# pragma GCC optimize ("O0")
+#endif
+inline uint32_t MurmurHash3_x32_32(
+        const void* key, const uint32_t len, const uint32_t seed) {
+#ifdef __GNUG__
+# pragma GCC pop_options
+#endif
+    constexpr uint32_t c1 = 0xCC9E2D51;
+    constexpr uint32_t c2 = 0x1B873593;
+    uint32_t h1 = seed;
+    const uint32_t* data = static_cast<const uint32_t*>(key);
+    const uint32_t* end = data + (len >> 2);
+    while (data != end) {
+        uint32_t k1 = *data++;
+        k1 *= c1;
+        k1 = (k1 << 15) | (k1 >> (32 - 15));
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = (h1 << 13) | (h1 >> (32 - 13));
+        h1 = h1 * 5 + 0xE6546B64;
+    }
+    h1 ^= len;
+    h1 ^= h1 >> 16;
+    h1 *= 0x85EBCA6B;
+    h1 ^= h1 >> 13;
+    h1 *= 0xC2B2AE35;
+    h1 ^= h1 >> 16;
+    return h1;
+}
+
+} // namespace legacy
+
+// Calls func(i) for i in [0, reps), each call produces samplesPerCall samples.
+// At least one call, the entries scale g_reps down.
+template <typename func_t>
+double measure(const std::string& name, const uint32_t cellSize, const char* pattern,
+        uint32_t reps, const uint32_t samplesPerCall, func_t&& func) {
+    reps = std::max(reps, 1u);
+    uint32_t sink = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < reps; ++i) {
+        sink += func(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    g_sink = sink;
+    const double ns = std::chrono::duration<double, std::nano>(end - begin).count()
+        / (double(reps) * samplesPerCall);
+    g_results.push_back({ name, cellSize, pattern, ns });
+    if (!g_json) {
+        std::string label = name;
+        if (cellSize != 0) {
+            label += " [" + std::to_string(cellSize) + ", " + pattern + "]";
+        }
+        else if (pattern[0] != '\0') {
+            label += std::string(" [") + pattern + "]";
+        }
+        std::cout << std::left << std::setw(40) << label
+            << std::right << std::fixed << std::setprecision(2) << std::setw(8) << ns << " ns"
+            << std::endl;
+    }
+    return ns;
+}
+
+template <typename func_t>
+double run(const char* name, func_t&& func) {
+    return measure(name, 0, "", g_reps, 1, func);
+}
+
+void compare(const double before, const double after) {
+    if (g_json) {
+        return;
+    }
+    std::cout << std::left << std::setw(40) << "  speedup"
+        << std::right << std::fixed << std::setprecision(2) << std::setw(8) << before / after << " x"
+        << std::endl;
+}
+
+// Raster walk vs. coordinates from a table of random values.
+class patterns_t {
+public:
+    patterns_t() {
+        utils::rng64 rng;
+        for (auto& value : m_random) {
+            value = rng() >> 24;
+        }
+    }
+    template <typename func_t>
+    void run(const std::string& name, const uint32_t cellSize, func_t&& func) const {
+        const uint32_t reps = g_reps / 10;
+        measure(name, cellSize, "sequential", reps, 1, [&](const uint64_t i) {
+            return func(i & 1023, (i >> 10) & 1023, (i >> 20) & 1023, i >> 30);
+        });
+        measure(name, cellSize, "random", reps, 1, [&](const uint64_t i) {
+            const uint64_t* p = m_random + ((i * 4) & (s_size - 1));
+            return func(p[0], p[1], p[2], p[3]);
+        });
+    }
+private:
+    static constexpr uint32_t s_size = 4096;
+    uint64_t m_random[s_size];
+};
+
+void suite() {
+    const patterns_t patterns;
+    if (!g_json) {
+        std::cout << "Suite" << std::endl;
+    }
+    patterns.run("MurmurHash3_x32_32(k0)", 0, [](auto x, auto, auto, auto) {
+        return utils::MurmurHash3_x32_32(x, 0);
+    });
+    patterns.run("MurmurHash3_x32_32(k0, k1)", 0, [](auto x, auto y, auto, auto) {
+        return utils::MurmurHash3_x32_32(x, y, 0);
+    });
+    patterns.run("MurmurHash3_x32_32(k0, k1, k2)", 0, [](auto x, auto y, auto z, auto) {
+        return utils::MurmurHash3_x32_32(x, y, z, 0);
+    });
+    patterns.run("MurmurHash3_x32_32(k0, k1, k2, k3)", 0, [](auto x, auto y, auto z, auto w) {
+        return utils::MurmurHash3_x32_32(x, y, z, w, 0);
+    });
+    {
+        uint64_t keys[16][4];
+        uint32_t hashes[16];
+        measure("MurmurHash3_x32_32_batch<4>", 0, "", g_reps / 10, 16, [&](const uint64_t i) {
+            for (uint32_t k = 0; k < 16; ++k) {
+                keys[k][0] = i + k;
+                keys[k][1] = keys[k][2] = keys[k][3] = i;
+            }
+            utils::MurmurHash3_x32_32_batch<4>(keys[0], 16, 0, hashes);
+            return hashes[i & 15];
+        });
+    }
+    {
+        utils::rng64 rng;
+        measure("rng64", 0, "", g_reps / 10, 16, [&](const uint64_t) {
+            uint64_t sum = 0;
+            for (uint32_t k = 0; k < 16; ++k) {
+                sum += rng();
+            }
+            return static_cast<uint32_t>(sum);
+        });
+        utils::stream64 stream(1);
+        uint64_t values[256];
+        measure("stream64::fill", 0, "", g_reps / 100, 256, [&](const uint64_t i) {
+            stream.fill(values);
+            return static_cast<uint32_t>(values[i & 255]);
+        });
+    }
+    {
+        // Raw values through each uniformizer, the tables of int2d with cellSize 64.
+        uint32_t raw[256];
+        utils::stream64 stream(1);
+        for (uint32_t& value : raw) {
+            value = static_cast<uint32_t>(stream() >> 32);
+        }
+        const uint32_t cellSizes[2] = { 64, 64 };
+        const noise::calibration::histogram_t count = noise::calibration::toHistogram(
+            noise::calibration::solve(noise::thread_pool::shared(), cellSizes, 2), 100'000'000);
+        measure("uniform offset_line_t[129]", 0, "", g_reps / 100, 256, [&](const uint64_t) {
+            uint32_t sum = 0;
+            for (const uint32_t value : raw) {
+                sum += noise::uniform(noise::intNd<2>::offsetLines(), value);
+            }
+            return sum;
+        });
+        const auto segments = noise::calibration::buildSegments<32>(noise::calibration::fitOffsets<6>(count));
+        measure("uniform offset_segments_t<32>", 0, "", g_reps / 100, 256, [&](const uint64_t) {
+            uint32_t sum = 0;
+            for (const uint32_t value : raw) {
+                sum += noise::uniform(segments, value);
+            }
+            return sum;
+        });
+        const auto quantiles = [&](const auto& table, const char* name) {
+            noise::calibration::buildQuantiles(count, *table);
+            uint32_t out[256];
+            measure(name, 0, "", g_reps / 100, 256, [&](const uint64_t i) {
+                noise::uniform(*table, raw, out, 256);
+                return out[i & 255];
+            });
+        };
+        quantiles(std::make_unique<noise::quantile_table_t<8>>(), "uniform quantile_table_t<8>");
+        quantiles(std::make_unique<noise::quantile_table_t<12>>(), "uniform quantile_table_t<12>");
+        quantiles(std::make_unique<noise::quantile_table_t<16>>(), "uniform quantile_table_t<16>");
+    }
+    for (const uint32_t cellSize : { 4u, 64u, 1024u }) {
+        const uint32_t b = cellSize - 1 + (g_cellSize - 64); // Not a compile-time constant
+        const utils::divider_u64 divider(b);
+        patterns.run("lerp_u32", cellSize, [b](auto x, auto y, auto, auto) {
+            return utils::lerp_u32(static_cast<uint32_t>(x % (b + 1)), b,
+                static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+        });
+        patterns.run("lerp_u32 divider_u64", cellSize, [b, &divider](auto x, auto y, auto, auto) {
+            return utils::lerp_u32(static_cast<uint32_t>(x % (b + 1)), divider,
+                static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+        });
+    }
+    for (const uint32_t size : { 4u, 64u, 1024u }) {
+        const uint32_t cellSize = size + (g_cellSize - 64);
+        noise::int1d int1d;
+        int1d.cellSize = cellSize;
+        noise::int2d int2d;
+        int2d.cellSize = { cellSize, cellSize };
+        noise::int3d int3d;
+        int3d.cellSize = { cellSize, cellSize, cellSize };
+        noise::int4d int4d;
+        int4d.cellSize = { cellSize, cellSize, cellSize, cellSize };
+
+        patterns.run("int1d::value", cellSize, [&](auto x, auto, auto, auto) {
+            return int1d.value(x);
+        });
+        patterns.run("int1d::valueRaw", cellSize, [&](auto x, auto, auto, auto) {
+            return int1d.valueRaw(x);
+        });
+        patterns.run("int2d::value", cellSize, [&](auto x, auto y, auto, auto) {
+            return int2d.value(x, y);
+        });
+        patterns.run("int2d::valueShifted", cellSize, [&](auto x, auto y, auto, auto) {
+            return int2d.valueShifted(x, y);
+        });
+        patterns.run("int2d::valueRaw", cellSize, [&](auto x, auto y, auto, auto) {
+            return int2d.valueRaw(x, y);
+        });
+        patterns.run("int3d::value", cellSize, [&](auto x, auto y, auto z, auto) {
+            return int3d.value(x, y, z);
+        });
+        patterns.run("int3d::valueShifted", cellSize, [&](auto x, auto y, auto z, auto) {
+            return int3d.valueShifted(x, y, z);
+        });
+        patterns.run("int3d::valueRaw", cellSize, [&](auto x, auto y, auto z, auto) {
+            return int3d.valueRaw(x, y, z);
+        });
+        patterns.run("int4d::value", cellSize, [&](auto x, auto y, auto z, auto w) {
+            return int4d.value(x, y, z, w);
+        });
+        patterns.run("int4d::valueShifted", cellSize, [&](auto x, auto y, auto z, auto w) {
+            return int4d.valueShifted(x, y, z, w);
+        });
+        patterns.run("int4d::valueRaw", cellSize, [&](auto x, auto y, auto z, auto w) {
+            return int4d.valueRaw(x, y, z, w);
+        });
+    }
+}
+
+const char* simdName() {
+#if defined(__AVX512F__)
+    return "avx512f";
+#elif defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE4_1__)
+    return "sse4.1";
+#else
+    return "none";
+#endif
+}
+
+// False if a result is not finite, JSON has no representation for it.
+bool printJson() {
+    for (const result_t& result : g_results) {
+        if (!std::isfinite(result.ns) || !std::isfinite(1e9 / result.ns)) {
+            std::cerr << "Non-finite result for " << result.name << std::endl;
+            return false;
+        }
+    }
+    std::cout << "{\n";
+    std::cout << "  \"simd\": \"" << simdName() << "\",\n";
+    std::cout << "  \"reps\": " << g_reps << ",\n";
+    std::cout << "  \"results\": [";
+    std::cout << std::setprecision(3) << std::fixed;
+    for (size_t i = 0; i < g_results.size(); ++i) {
+        const result_t& result = g_results[i];
+        // Names are plain identifiers and punctuation, nothing to escape.
+        std::cout << (i == 0 ? "\n" : ",\n")
+            << "    { \"name\": \"" << result.name << "\""
+            << ", \"cell_size\": " << result.cellSize
+            << ", \"pattern\": \"" << result.pattern << "\""
+            << ", \"ns_per_sample\": " << result.ns
+            << ", \"samples_per_second\": " << 1e9 / result.ns << " }";
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    return true;
+}
+
+int32_t main(const int32_t argc, const char* argv[]) {
+    // benchmark [--json] [--reps N] [--suite]
+    bool suiteOnly = false;
+    for (int32_t i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            g_json = true;
+        }
+        else if (std::strcmp(argv[i], "--suite") == 0) {
+            suiteOnly = true;
+        }
+        else if (std::strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            g_reps = std::max(10u, static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)));
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--json] [--reps N] [--suite]" << std::endl;
+            return 1;
+        }
+    }
+    if (suiteOnly) {
+        suite();
+        if (g_json && !printJson()) {
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!g_json) {
+        std::cout << "Hashing" << std::endl;
+    }
+    {
+        const double before = run("legacy MurmurHash3_x32_32(u64[1])", [](const uint64_t i) {
+            const uint64_t key[1] = { i };
+            return legacy::MurmurHash3_x32_32(key, sizeof(key), 0);
+        });
+        const double after = run("MurmurHash3_x32_32(k0)", [](const uint64_t i) {
+            return utils::MurmurHash3_x32_32(i, 0);
+        });
+        compare(before, after);
+    }
+    {
+        const double before = run("legacy MurmurHash3_x32_32(u64[2])", [](const uint64_t i) {
+            const uint64_t key[2] = { i, i * 3 };
+            return legacy::MurmurHash3_x32_32(key, sizeof(key), 0);
+        });
+        const double after = run("MurmurHash3_x32_32(k0, k1)", [](const uint64_t i) {
+            return utils::MurmurHash3_x32_32(i, i * 3, 0);
+        });
+        compare(before, after);
+    }
+    {
+        const double before = run("legacy MurmurHash3_x32_32(u64[3])", [](const uint64_t i) {
+            const uint64_t key[3] = { i, i * 3, i * 5 };
+            return legacy::MurmurHash3_x32_32(key, sizeof(key), 0);
+        });
+        const double after = run("MurmurHash3_x32_32(k0, k1, k2)", [](const uint64_t i) {
+            return utils::MurmurHash3_x32_32(i, i * 3, i * 5, 0);
+        });
+        compare(before, after);
+    }
+    {
+        const double before = run("legacy MurmurHash3_x32_32(u64[4])", [](const uint64_t i) {
+            const uint64_t key[4] = { i, i * 3, i * 5, i * 7 };
+            return legacy::MurmurHash3_x32_32(key, sizeof(key), 0);
+        });
+        const double after = run("MurmurHash3_x32_32(k0, k1, k2, k3)", [](const uint64_t i) {
+            return utils::MurmurHash3_x32_32(i, i * 3, i * 5, i * 7, 0);
+        });
+        compare(before, after);
+    }
+
+    if (!g_json) {
+        std::cout << "Noise" << std::endl;
+    }
+    const uint32_t cellSize = g_cellSize;
+    noise::int1d int1d;
+    int1d.cellSize = cellSize;
+    noise::int2d int2d;
+    int2d.cellSize = { cellSize, cellSize };
+    noise::int3d int3d;
+    int3d.cellSize = { cellSize, cellSize, cellSize };
+    noise::int4d int4d;
+    int4d.cellSize = { cellSize, cellSize, cellSize, cellSize };
+    run("int1d::value", [&](const uint64_t i) {
+        return int1d.value(i);
+    });
+    run("int2d::value", [&](const uint64_t i) {
+        return int2d.value(i, i * 3);
+    });
+    run("int3d::value", [&](const uint64_t i) {
+        return int3d.value(i, i * 3, i * 5);
+    });
+    run("int4d::value", [&](const uint64_t i) {
+        return int4d.value(i, i * 3, i * 5, i * 7);
+    });
+
+    {
+        const double before = run("int1d::value, consecutive x", [&](const uint64_t i) {
+            return int1d.value(i);
+        });
+        noise::int1d::cursor it = int1d.at(0);
+        const double after = run("int1d::cursor", [&](const uint64_t) {
+            const uint32_t value = *it;
+            ++it;
+            return value;
+        });
+        compare(before, after);
+    }
+
+    const noise::int1d::prepared int1dPrepared(int1d);
+    const noise::int2d::prepared int2dPrepared(int2d);
+    const noise::int3d::prepared int3dPrepared(int3d);
+    const noise::int4d::prepared int4dPrepared(int4d);
+    run("int1d::prepared::value", [&](const uint64_t i) {
+        return int1dPrepared.value(i);
+    });
+    run("int2d::prepared::value", [&](const uint64_t i) {
+        return int2dPrepared.value(i, i * 3);
+    });
+    run("int3d::prepared::value", [&](const uint64_t i) {
+        return int3dPrepared.value(i, i * 3, i * 5);
+    });
+    run("int4d::prepared::value", [&](const uint64_t i) {
+        return int4dPrepared.value(i, i * 3, i * 5, i * 7);
+    });
+    {
+        // A random walk with steps of -3..3 along every axis.
+        constexpr uint32_t steps = 4096;
+        std::vector<std::array<uint64_t, 4>> walk(steps);
+        utils::rng64 rng;
+        std::array<uint64_t, 4> p = { 1 << 20, 1 << 20, 1 << 20, 1 << 20 };
+        for (auto& point : walk) {
+            const uint64_t r = rng();
+            for (uint32_t k = 0; k < 4; ++k) {
+                p[k] += ((r >> (k * 8)) % 7) - 3;
+            }
+            point = p;
+        }
+        const double before3 = run("int3d::prepared::value, walk", [&](const uint64_t i) {
+            const auto& q = walk[i % steps];
+            return int3dPrepared.value(q[0], q[1], q[2]);
+        });
+        noise::int3d::locality_t int3dLocality(int3d);
+        const double after3 = run("int3d::locality_t::value, walk", [&](const uint64_t i) {
+            const auto& q = walk[i % steps];
+            return int3dLocality.value(q[0], q[1], q[2]);
+        });
+        compare(before3, after3);
+        const double before4 = run("int4d::prepared::value, walk", [&](const uint64_t i) {
+            const auto& q = walk[i % steps];
+            return int4dPrepared.value(q[0], q[1], q[2], q[3]);
+        });
+        noise::int4d::locality_t int4dLocality(int4d);
+        const double after4 = run("int4d::locality_t::value, walk", [&](const uint64_t i) {
+            const auto& q = walk[i % steps];
+            return int4dLocality.value(q[0], q[1], q[2], q[3]);
+        });
+        compare(before4, after4);
+    }
+
+    const noise::basic_int1d<64> int1dFixed;
+    const noise::basic_int2d<64, 64> int2dFixed;
+    const noise::basic_int3d<64, 64, 64> int3dFixed;
+    const noise::basic_int4d<64, 64, 64, 64> int4dFixed;
+    run("basic_int1d<64>::value", [&](const uint64_t i) {
+        return int1dFixed.value(i);
+    });
+    run("basic_int2d<64, 64>::value", [&](const uint64_t i) {
+        return int2dFixed.value(i, i * 3);
+    });
+    run("basic_int3d<64, 64, 64>::value", [&](const uint64_t i) {
+        return int3dFixed.value(i, i * 3, i * 5);
+    });
+    run("basic_int4d<64, 64, 64, 64>::value", [&](const uint64_t i) {
+        return int4dFixed.value(i, i * 3, i * 5, i * 7);
+    });
+    noise::intNd<4> int4dGeneric;
+    std::fill(int4dGeneric.cellSize, int4dGeneric.cellSize + 4, cellSize);
+    noise::intNd<5> int5dGeneric;
+    std::fill(int5dGeneric.cellSize, int5dGeneric.cellSize + 5, cellSize);
+    run("intNd<4>::value", [&](const uint64_t i) {
+        return int4dGeneric.value(i, i * 3, i * 5, i * 7);
+    });
+    run("intNd<5>::value", [&](const uint64_t i) {
+        return int5dGeneric.value(i, i * 3, i * 5, i * 7, i * 9);
+    });
+    {
+        constexpr uint32_t size = 256;
+        std::vector<uint32_t> image(size * size * 4);
+        uint64_t frame = 0;
+        const double before = run("int3d::prepared::value, 256x256x4", [&](const uint64_t i) {
+            if (i % (size * size * 4) == 0) {
+                const noise::int3d::prepared prepared(int3d);
+                for (uint32_t z = 0; z < 4; ++z) {
+                    for (uint32_t y = 0; y < size; ++y) {
+                        for (uint32_t x = 0; x < size; ++x) {
+                            image[(z * size + y) * size + x] = prepared.value(x, y, frame + z);
+                        }
+                    }
+                }
+                ++frame;
+            }
+            return image[i % (size * size * 4)];
+        });
+        frame = 0;
+        const double shifted = run("int3d::prepared::value, shifts", [&](const uint64_t i) {
+            if (i % (size * size * 4) == 0) {
+                const noise::int3d::prepared prepared(int3d);
+                const noise::int3d::shifts fields(int3d.cellSize, 0, 0, frame, size, size, 4);
+                for (uint32_t z = 0; z < 4; ++z) {
+                    for (uint32_t y = 0; y < size; ++y) {
+                        for (uint32_t x = 0; x < size; ++x) {
+                            image[(z * size + y) * size + x] = prepared.value(x, y, frame + z, fields);
+                        }
+                    }
+                }
+                ++frame;
+            }
+            return image[i % (size * size * 4)];
+        });
+        compare(before, shifted);
+        noise::thread_pool pool;
+        frame = 0;
+        const double after = run("parallel_fill int3d, 256x256x4", [&](const uint64_t i) {
+            if (i % (size * size * 4) == 0) {
+                noise::parallel_fill(pool, int3d, 0, 0, frame, size, size, 4,
+                    image.data(), size, size * size);
+                ++frame;
+            }
+            return image[i % (size * size * 4)];
+        });
+        if (!g_json) {
+            std::cout << std::left << std::setw(40) << "  threads"
+                << std::right << std::setw(8) << pool.size() << std::endl;
+        }
+        compare(before, after);
+    }
+    {
+        constexpr uint32_t size = 512;
+        std::vector<uint32_t> image(size * size);
+        uint64_t frame = 0;
+        run("int2d::fill, 512x512", [&](const uint64_t i) {
+            if (i % (size * size) == 0) {
+                int2d.fill(0, frame * size, size, size, image.data(), size);
+                ++frame;
+            }
+            return image[i % (size * size)];
+        });
+        frame = 0;
+        const double before = run("int4d::prepared::value, 512x512", [&](const uint64_t i) {
+            if (i % (size * size) == 0) {
+                const noise::int4d::prepared prepared(int4d);
+                for (uint32_t y = 0; y < size; ++y) {
+                    for (uint32_t x = 0; x < size; ++x) {
+                        image[y * size + x] = prepared.value(x, y, frame, frame * 3);
+                    }
+                }
+                ++frame;
+            }
+            return image[i % (size * size)];
+        });
+        frame = 0;
+        const double after = run("int4d::slice_t::fill, 512x512", [&](const uint64_t i) {
+            if (i % (size * size) == 0) {
+                int4d.slice(frame, frame * 3).fill(0, 0, size, size, image.data(), size);
+                ++frame;
+            }
+            return image[i % (size * size)];
+        });
+        compare(before, after);
+        noise::int4d::animation_t animation = int4d.animation(0, 0, size, size, 0);
+        frame = 0;
+        const double animated = run("int4d::animation_t::fill, 512x512", [&](const uint64_t i) {
+            if (i % (size * size) == 0) {
+                animation.fill(frame++, image.data(), size);
+            }
+            return image[i % (size * size)];
+        });
+        compare(before, animated);
+        frame = 0;
+        const double before3 = run("int3d::prepared::value, 512x512", [&](const uint64_t i) {
+            if (i % (size * size) == 0) {
+                const noise::int3d::prepared prepared(int3d);
+                for (uint32_t y = 0; y < size; ++y) {
+                    for (uint32_t x = 0; x < size; ++x) {
+                        image[y * size + x] = prepared.value(x, y, frame);
+                    }
+                }
+                ++frame;
+            }
+            return image[i % (size * size)];
+        });
+        frame = 0;
+        const double after3 = run("int3d::slice_t::fill, 512x512", [&](const uint64_t i) {
+            if (i % (size * size) == 0) {
+                int3d.slice(frame).fill(0, 0, size, size, image.data(), size);
+                ++frame;
+            }
+            return image[i % (size * size)];
+        });
+        compare(before3, after3);
+        noise::int3d::slab_t stream = int3d.slab(0, 0, size, size, 0);
+        const double slab = run("int3d::slab_t::next, 512x512", [&](const uint64_t i) {
+            if (i % (size * size) == 0) {
+                stream.next(image.data(), size);
+            }
+            return image[i % (size * size)];
+        });
+        compare(before3, slab);
+    }
+
+    suite();
+    if (g_json && !printJson()) {
+        return 1;
+    }
+    return 0;
+}
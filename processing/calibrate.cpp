@@ -0,0 +1,339 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../calibration.hpp"
+
+namespace calibration = noise::calibration;
+
+namespace {
+    uint64_t g_reps = 100'000'000;
+    uint64_t g_seed = 1;
+    uint32_t g_threads = 0; // All cores
+    calibration::sequence_t g_sequence = calibration::sequence_t::random;
+    bool g_solve = false; // Step 1 by calibration::solve() instead of sampling
+    bool g_continuous = false; // Offset lines meeting at the segment bounds
+    uint32_t g_segments = 0; // Adaptive segments 16, 32, 64 or 128, 0 = off
+    uint32_t g_quantiles = 0; // Quantile table bits 8, 10, 12, 14 or 16, 0 = off
+    constexpr uint32_t g_segmentsMax = 128;
+
+    struct result_t {
+        uint32_t dims = 0;
+        uint32_t cellSize = 0;
+        calibration::table_t table;
+        calibration::uniformity_t raw;
+        calibration::uniformity_t builtin;
+        calibration::uniformity_t calibrated;
+        // The first g_segments entries, the rest is padding.
+        noise::offset_segments_t<g_segmentsMax> segments;
+        double segmentsError = 0.0;
+        calibration::uniformity_t segmented;
+        std::vector<uint32_t> quantiles; // 2^g_quantiles + 1 knots
+        calibration::uniformity_t quantiled;
+    };
+} // namespace
+
+std::vector<uint32_t> parseList(const char* text) {
+    std::vector<uint32_t> list;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        list.push_back(static_cast<uint32_t>(std::strtoul(item.c_str(), nullptr, 10)));
+    }
+    return list;
+}
+
+void printUniformity(const char* name, const calibration::uniformity_t& uniformity) {
+    std::cout << "  " << std::left << std::setw(12) << name << std::right << std::fixed
+        << " max " << std::setprecision(3) << std::setw(8) << uniformity.maxDeviation * 100.0 << " %"
+        << "  rms " << std::setprecision(3) << std::setw(8) << uniformity.rmsDeviation * 100.0 << " %"
+        << std::endl;
+}
+
+template <uint32_t segments, uint8_t degree>
+void buildSegments(const utils::Polyfit<double, degree>& offsets, result_t& result) {
+    const noise::offset_segments_t<segments> table =
+        calibration::buildSegments<segments>(offsets, &result.segmentsError);
+    for (uint32_t i = 0; i < g_segmentsMax; ++i) {
+        result.segments.begin[i] = i < segments ? table.begin[i] : UINT32_MAX;
+        result.segments.lines[i] = i < segments ? table.lines[i] : noise::offset_line_t{ 0, 0 };
+    }
+}
+
+template <uint8_t degree>
+void buildTables(const utils::Polyfit<double, degree>& offsets, result_t& result) {
+    uint32_t overflows = 0;
+    result.table = calibration::buildTable(offsets, &overflows, g_continuous);
+    if (overflows != 0) {
+        std::cout << "  Warning: " << overflows << " slopes with |slope| > UINT32_MAX" << std::endl;
+    }
+    switch (g_segments) {
+    case 16: buildSegments<16>(offsets, result); break;
+    case 32: buildSegments<32>(offsets, result); break;
+    case 64: buildSegments<64>(offsets, result); break;
+    case 128: buildSegments<128>(offsets, result); break;
+    default: break;
+    }
+}
+
+// series: the solved distribution, empty if collected.
+template <uint32_t bits, uint32_t dims, typename raw_t>
+void buildQuantiles(noise::thread_pool& pool, const calibration::sampling_t& sampling,
+        const std::vector<double>& series, const calibration::histogram_t& count,
+        const raw_t& raw, result_t& result) {
+    const auto table = std::make_unique<noise::quantile_table_t<bits>>();
+    if (series.empty()) {
+        calibration::buildQuantiles(count, *table);
+    }
+    else {
+        calibration::buildQuantiles(pool, series, *table);
+    }
+    result.quantiles.assign(table->cdf, table->cdf + table->knots);
+    result.quantiled = calibration::measure(calibration::collect<dims>(pool, g_reps, sampling,
+        [&](const uint64_t (&p)[dims]) {
+            return noise::uniform(*table, raw(p));
+        }));
+}
+
+template <uint32_t dims>
+result_t calibrate(noise::thread_pool& pool, const uint32_t cellSize) {
+    noise::intNd<dims> n;
+    std::fill(n.cellSize, n.cellSize + dims, cellSize);
+    const auto raw = [&n](const uint64_t (&p)[dims]) {
+        if constexpr (dims == 1) {
+            return n.valueRaw(p);
+        }
+        else {
+            return n.valueShifted(p);
+        }
+    };
+    result_t result;
+    result.dims = dims;
+    result.cellSize = cellSize;
+    calibration::sampling_t sampling;
+    sampling.seed = g_seed;
+    sampling.sequence = g_sequence;
+    sampling.cellSize = cellSize;
+
+    std::cout << "int" << dims << "d, cellSize " << cellSize << std::endl;
+    calibration::histogram_t count;
+    std::vector<double> series;
+    if (g_solve) {
+        std::cout << " Step 1. Solving the distribution" << std::endl;
+        const std::vector<uint32_t> cellSizes(dims, cellSize);
+        series = calibration::solveSeries(pool, cellSizes.data(), dims);
+        count = calibration::toHistogram(calibration::toBins(series), 100'000'000);
+    }
+    else {
+        std::cout << " Step 1. Collection of the distribution statistics" << std::endl;
+        count = calibration::collect<dims>(pool, g_reps, sampling, raw);
+    }
+    result.raw = calibration::measure(count);
+
+    std::cout << " Steps 2-5. Building the offsets table" << std::endl;
+    if constexpr (dims == 1) {
+        buildTables(calibration::fitOffsets<5>(count), result);
+    }
+    else {
+        buildTables(calibration::fitOffsets<6>(count), result);
+    }
+
+    std::cout << " Step 6. Collection of the new distribution statistics" << std::endl;
+    // A new stream, so that the table is not measured on its own input.
+    sampling.seed = utils::rng64::mix(g_seed);
+    result.builtin = calibration::measure(calibration::collect<dims>(pool, g_reps, sampling,
+        [&](const uint64_t (&p)[dims]) {
+            return noise::uniform(noise::intNd<dims>::offsetLines(), raw(p));
+        }));
+    result.calibrated = calibration::measure(calibration::collect<dims>(pool, g_reps, sampling,
+        [&](const uint64_t (&p)[dims]) {
+            return noise::uniform(result.table.lines, raw(p));
+        }));
+    printUniformity("raw", result.raw);
+    printUniformity("built-in", result.builtin);
+    printUniformity("calibrated", result.calibrated);
+    if (g_segments != 0) {
+        result.segmented = calibration::measure(calibration::collect<dims>(pool, g_reps, sampling,
+            [&](const uint64_t (&p)[dims]) {
+                return noise::uniform(result.segments, raw(p));
+            }));
+        printUniformity("segmented", result.segmented);
+        std::cout << "  " << g_segments << " segments, max error "
+            << std::setprecision(0) << result.segmentsError << std::endl;
+    }
+    switch (g_quantiles) {
+    case 8: buildQuantiles<8, dims>(pool, sampling, series, count, raw, result); break;
+    case 10: buildQuantiles<10, dims>(pool, sampling, series, count, raw, result); break;
+    case 12: buildQuantiles<12, dims>(pool, sampling, series, count, raw, result); break;
+    case 14: buildQuantiles<14, dims>(pool, sampling, series, count, raw, result); break;
+    case 16: buildQuantiles<16, dims>(pool, sampling, series, count, raw, result); break;
+    default: break;
+    }
+    if (g_quantiles != 0) {
+        printUniformity("quantiles", result.quantiled);
+    }
+    return result;
+}
+
+bool writeHeader(const char* path, const std::vector<result_t>& results) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << std::fixed << std::setprecision(3);
+    file << "// Generated by simple-uniform-noise-calibrate, do not edit.\n"
+        "// reps " << g_reps << ", seed " << g_seed
+        << (g_sequence == calibration::sequence_t::sobol ? ", sobol" : "")
+        << (g_solve ? ", solved" : "")
+        << (g_continuous ? ", continuous" : "") << "\n"
+        "#pragma once\n"
+        "#ifndef SIMPLE_UNIFORM_NOISE_OFFSET_TABLES\n"
+        "#define SIMPLE_UNIFORM_NOISE_OFFSET_TABLES\n"
+        "#include \"noise.hpp\"\n"
+        "\n"
+        "namespace noise {\n"
+        "namespace offset_tables {\n";
+    for (const result_t& result : results) {
+        file << "\n"
+            "// Max deviation: raw " << result.raw.maxDeviation * 100.0
+            << " %, calibrated " << result.calibrated.maxDeviation * 100.0 << " %\n"
+            "inline constexpr offset_line_t int" << result.dims << "d_" << result.cellSize
+            << "[" << calibration::g_offsetLines << " + 1] = {\n";
+        for (uint32_t i = 0; i < calibration::g_offsetLines; ++i) {
+            file << "    { INT64_C(" << result.table.lines[i].slope
+                << "), INT64_C(" << result.table.lines[i].intercept << ") },\n";
+        }
+        file << "    { 0, 0 },\n"
+            "};\n";
+        if (g_quantiles != 0) {
+            file << "\n"
+                "// Max deviation: quantiles " << result.quantiled.maxDeviation * 100.0 << " %\n"
+                "inline constexpr quantile_table_t<" << g_quantiles << "> int" << result.dims << "d_"
+                << result.cellSize << "_quantiles = {\n"
+                "    {";
+            for (size_t i = 0; i < result.quantiles.size(); ++i) {
+                file << (i % 8 == 0 ? "\n        " : " ") << result.quantiles[i] << "u,";
+            }
+            file << "\n    },\n"
+                "};\n";
+        }
+        if (g_segments == 0) {
+            continue;
+        }
+        file << "\n"
+            "// Max deviation: segmented " << result.segmented.maxDeviation * 100.0
+            << " %, max error " << std::setprecision(0) << result.segmentsError << std::setprecision(3)
+            << "\n"
+            "inline constexpr offset_segments_t<" << g_segments << "> int" << result.dims << "d_"
+            << result.cellSize << "_segments = {\n"
+            "    {";
+        for (uint32_t i = 0; i < g_segments; ++i) {
+            file << (i % 8 == 0 ? "\n        " : " ") << result.segments.begin[i] << "u,";
+        }
+        file << "\n    },\n"
+            "    {\n";
+        for (uint32_t i = 0; i < g_segments; ++i) {
+            file << "        { INT64_C(" << result.segments.lines[i].slope
+                << "), INT64_C(" << result.segments.lines[i].intercept << ") },\n";
+        }
+        file << "    },\n"
+            "};\n";
+    }
+    file << "\n"
+        "} // namespace offset_tables\n"
+        "} // namespace noise\n"
+        "\n"
+        "#endif // SIMPLE_UNIFORM_NOISE_OFFSET_TABLES\n";
+    return static_cast<bool>(file);
+}
+
+int32_t main(const int32_t argc, const char* argv[]) {
+    std::vector<uint32_t> dims = { 1, 2, 3, 4 };
+    std::vector<uint32_t> cellSizes = { 64 };
+    const char* out = "offset_tables.hpp";
+    for (int32_t i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--dims") == 0 && hasValue) {
+            dims = parseList(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--cell-sizes") == 0 && hasValue) {
+            cellSizes = parseList(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--reps") == 0 && hasValue) {
+            g_reps = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            g_seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            g_threads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--solve") == 0) {
+            g_solve = true;
+        }
+        else if (std::strcmp(argv[i], "--continuous") == 0) {
+            g_continuous = true;
+        }
+        else if (std::strcmp(argv[i], "--segments") == 0 && hasValue) {
+            g_segments = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            if (g_segments != 16 && g_segments != 32 && g_segments != 64 && g_segments != 128) {
+                std::cerr << "--segments must be 16, 32, 64 or 128" << std::endl;
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--quantiles") == 0 && hasValue) {
+            g_quantiles = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            if (g_quantiles < 8 || g_quantiles > 16 || g_quantiles % 2 != 0) {
+                std::cerr << "--quantiles must be 8, 10, 12, 14 or 16" << std::endl;
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--sobol") == 0) {
+            g_sequence = calibration::sequence_t::sobol;
+        }
+        else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            out = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--dims 1,2,3,4,5] [--cell-sizes 64,...]"
+                " [--reps N] [--seed N] [--threads N] [--sobol] [--solve]"
+                " [--continuous] [--segments 16|32|64|128] [--quantiles 8..16]"
+                " [--out offset_tables.hpp]"
+                << std::endl;
+            return 1;
+        }
+    }
+
+    noise::thread_pool pool(g_threads);
+    std::vector<result_t> results;
+    for (const uint32_t d : dims) {
+        for (const uint32_t cellSize : cellSizes) {
+            if (cellSize < 2) {
+                std::cerr << "cellSize must be at least 2" << std::endl;
+                return 1;
+            }
+            switch (d) {
+            case 1: results.push_back(calibrate<1>(pool, cellSize)); break;
+            case 2: results.push_back(calibrate<2>(pool, cellSize)); break;
+            case 3: results.push_back(calibrate<3>(pool, cellSize)); break;
+            case 4: results.push_back(calibrate<4>(pool, cellSize)); break;
+            case 5: results.push_back(calibrate<5>(pool, cellSize)); break;
+            default:
+                std::cerr << "Unsupported dimension " << d << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (!writeHeader(out, results)) {
+        std::cerr << "Failed to write " << out << std::endl;
+        return 1;
+    }
+    std::cout << "Written " << out << std::endl;
+    return 0;
+}
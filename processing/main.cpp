@@ -114,6 +114,7 @@ void calc() {
 
         polyfit.add(h, count[x]);
     }
+    const auto p = polyfit.polynomial();
 # ifdef DEBUG_CALC_COUT
     for (const auto& weight : polyfit.weights()) {
         std::cout << "  " << weight;
@@ -125,7 +126,7 @@ void calc() {
         // 0  x  img/2-1
         // 0  xx  U32/2
         const uint32_t xx = utils::lerp_u32(x, img.getSize().x / 2 - 1, UINT32_MAX / 2);
-        const auto yy = polyfit.y(xx);
+        const auto yy = p.y(xx);
         constexpr size_t size = UINT32_MAX / count.size() + 1;
         const size_t idx = xx / size;
 #     ifdef DEBUG_CALC_COUT
@@ -225,8 +226,8 @@ void calc() {
     // 3737373737373737373737373737373737373737373737 |36| -3  -1 10:23:8 -1.94
     // 3737373838383838383838383838383838383838383838 |37| -2  -0 15:23:3 -0.66
     // 383838383838383838383838383838383838383838     |38| -1  -0 20:21   -0.51
-    const double yMin = polyfit.y(0.0);
-    const double yMax = polyfit.y(UINT32_MAX / 2);
+    const double yMin = p.y(0.0);
+    const double yMax = p.y(UINT32_MAX / 2);
     //assert(yMin < yMax);
 # ifdef DEBUG_CALC_COUT
     std::cout << "yMin=" << yMin << " yMax=" << yMax << std::endl;
@@ -238,7 +239,7 @@ void calc() {
             1, row, g_tableRows,
             0, UINT32_MAX / 2
         );
-        const double y = polyfit.y(x);
+        const double y = p.y(x);
         const uint32_t h = utils::lerp_f64(
             0, y, yMax,
             1, heightMax
@@ -270,7 +271,7 @@ void calc() {
             1, rowSrc, g_tableRows,
             0, UINT32_MAX / 2
         );
-        const double y = polyfit.y(x);
+        const double y = p.y(x);
         const uint32_t h = utils::lerp_f64(
             0, y, yMax,
             1, heightMax
@@ -350,53 +351,24 @@ void calc() {
     utils::Polyfit<double, 1> pfLines;
     uint32_t idxPrev = 0;
     std::cout <<
-        "uint32_t getOffsetU32(const uint32_t x_) noexcept {\n"
-        "    if (x_ == 0) {\n"
-        "        return 0;\n"
-        "    }\n"
-        "    constexpr uint32_t size = (UINT32_MAX / 2) / " << g_offsetLines << " + 1;\n"
-        "    const uint64_t x = x_;\n"
-        "    uint64_t offset = 0;\n"
-        "    switch (x_ / size) {\n";
+        "    static constexpr offset_line_t s_offsetLines[" << g_offsetLines << " + 1] = {\n";
     constexpr double k = UINT64_C(1) << 31;
     constexpr uint64_t ki = static_cast<uint64_t>(k);
-    static const auto pri = [](const uint32_t idx, const double w1, const double w0) {
-        const uint64_t w1i = std::abs(static_cast<int64_t>(w1 * k));
-        const uint64_t w0i = std::abs(static_cast<int64_t>(w0));
-        if (w1i > UINT32_MAX) {
+    static const auto pri = [](const double w1, const double w0) {
+        const int64_t w1i = static_cast<int64_t>(w1 * k);
+        const int64_t w0i = static_cast<int64_t>(w0);
+        if (static_cast<uint64_t>(std::abs(w1i)) > UINT32_MAX) {
             std::cout << "Warning: |" << w1 << " * " << ki << "| > UINT32_MAX\n";
         }
-        if (w1 < 0.0) {
-            if (w0 < 0.0) { // w1 < 0, w0 < 0
-                std::cout << "Error: w1 < 0 && w0 < 0\n";
-            }
-            else { // w1 < 0, w0 > 0
-                std::cout
-                    << "    case " << idx << ": offset = UINT64_C(" << w0i
-                    << ") - (x * UINT64_C(" << w1i << ")) / UINT64_C("
-                    << ki << "); break;\n";
-            }
-        }
-        else {
-            if (w0 < 0.0) { // w1 > 0, w0 < 0
-                std::cout
-                    << "    case " << idx << ": offset = (x * UINT64_C(" << w1i
-                    << ")) / UINT64_C(" << ki << ") - UINT64_C(" << w0i
-                    << "); break;\n";
-            }
-            else { // w1 > 0, w0 > 0
-                std::cout
-                    << "    case " << idx << ": offset = (x * UINT64_C(" << w1i
-                    << ")) / UINT64_C(" << ki << ") + UINT64_C(" << w0i
-                    << "); break;\n";
-            }
-        }
+        std::cout
+            << "        { INT64_C(" << w1i << "), INT64_C(" << w0i << ") },\n";
     };
+    const auto offsetFit = g_polyfit.polynomial();
     for (uint32_t x = 0; x < img.getSize().x; ++x) {
         // 0  x  img-1
         // 0  xx  U32/2
         const uint32_t xx = utils::lerp_u32(x, img.getSize().x, UINT32_MAX / 2);
-        const uint32_t yy = g_polyfit.y(xx);
+        const uint32_t yy = offsetFit.y(xx);
         // 0  yy  offsetMax
         // 0  h   img-1
         const uint32_t h = utils::lerp_u32(yy, offsetMax, img.getSize().y - 1);
@@ -428,7 +400,7 @@ void calc() {
                 const uint32_t y2 = utils::lerp_u32(yy2, offsetMax, img.getSize().y - 1);
                 img.setPixel(x2, img.getSize().y - y2 - 1, sf::Color::Red);
             }
-            pri(idxPrev, pfLines.weights()[1], pfLines.weights()[0]);
+            pri(pfLines.weights()[1], pfLines.weights()[0]);
             idxPrev = idx;
             pfLines.reset();
         }
@@ -452,15 +424,10 @@ void calc() {
         const uint32_t y2 = utils::lerp_u32(yy2, offsetMax, img.getSize().y - 1);
         //img.setPixel(x2, img.getSize().y - y2 - 1, sf::Color::Red);
     }
-    pri(idxPrev, pfLines.weights()[1], pfLines.weights()[0]);
+    pri(pfLines.weights()[1], pfLines.weights()[0]);
     std::cout <<
-        "    default: offset = 0; break;\n"
-        "    }\n"
-        "    if (offset > x) {\n"
-        "        offset = x;\n"
-        "    }\n"
-        "    return offset;\n"
-        "}" << std::endl;
+        "        { 0, 0 },\n"
+        "    };" << std::endl;
 
     displayImg(img);
 # ifdef DEBUG_CALC_COUT
@@ -0,0 +1,1069 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "../calibration.hpp"
+#include "../noise.hpp"
+#include "../parallel.hpp"
+
+// Bit-exactness checks. The checksums are of the v0.1 release, every other
+// evaluator is compared with value() of the same noise.
+
+namespace {
+    uint32_t g_failures = 0;
+    bool g_exhaustive = false; // uniform() over all 2^32 inputs
+
+    void check(const bool ok, const char* what) {
+        if (!ok) {
+            ++g_failures;
+            std::printf("FAILED: %s\n", what);
+        }
+    }
+
+    // FNV-1a over 32-bit words
+    class checksum_t {
+    public:
+        void add(const uint32_t v) noexcept {
+            m_hash = (m_hash ^ v) * UINT64_C(0x100000001B3);
+        }
+        uint64_t get() const noexcept {
+            return m_hash;
+        }
+    private:
+        uint64_t m_hash = UINT64_C(0xCBF29CE484222325);
+    };
+
+    uint64_t splitmix64(uint64_t& state) noexcept {
+        uint64_t z = (state += UINT64_C(0x9E3779B97F4A7C15));
+        z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+        z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+        return z ^ (z >> 31);
+    }
+
+    constexpr uint32_t g_cellSizes[][4] = {
+        { 2, 2, 2, 2 },
+        { 3, 3, 3, 3 },
+        { 64, 64, 64, 64 },
+        { 100, 100, 100, 100 },
+        { 4103, 4103, 4103, 4103 },
+        { UINT32_C(1) << 31, UINT32_C(1) << 31, UINT32_C(1) << 31, UINT32_C(1) << 31 },
+        { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX },
+        { 64, 3, 1000, 2 },
+        { UINT32_MAX, 7, 64, 65536 },
+    };
+    // Cells much thinner along z and w than along x, where the slab and
+    // animation rings are the largest. Not part of the checksums.
+    constexpr uint32_t g_thinCellSizes[][4] = {
+        { 1024, 1024, 2, 2 },
+        { 65536, 64, 2, 3 },
+    };
+    constexpr uint32_t g_seeds[] = { 0, 0x9E3779B9 };
+    constexpr uint32_t g_points = 768;
+    constexpr uint32_t g_uniformStep = 4099;
+
+    // v0.1 checksums of uniform() for 1..4 dimensions, every g_uniformStep-th
+    // input and all of them.
+    constexpr uint64_t g_uniformChecksums[4] = {
+        UINT64_C(0x0FBD5D8BC49E2AE1),
+        UINT64_C(0xC6756A511A2C0DA4),
+        UINT64_C(0x16833C3413D1DDB5),
+        UINT64_C(0xE8119039B580AD62),
+    };
+    constexpr uint64_t g_uniformExhaustiveChecksums[4] = {
+        UINT64_C(0x33BECFA5212F2EA8),
+        UINT64_C(0x3116097BD9784F1B),
+        UINT64_C(0x118D912E24B0DC2E),
+        UINT64_C(0x55E657786F2808F3),
+    };
+    // v0.1 checksums of value() and valueRaw() of int1d..int4d, see valueChecksum().
+    constexpr uint64_t g_valueChecksums[4] = {
+        UINT64_C(0xF60527355FC7E099),
+        UINT64_C(0x15795B0180C6ED05),
+        UINT64_C(0xD9F3A8AD5688979E),
+        UINT64_C(0xB2301DCAA59F5050),
+    };
+    constexpr uint64_t g_valueRawChecksums[4] = {
+        UINT64_C(0xE458FA1F68A0A938),
+        UINT64_C(0xB6A0141F6E6CAA9C),
+        UINT64_C(0xC6F66731E57E7EE0),
+        UINT64_C(0x7CD1CA8A8E6599BC),
+    };
+
+    // Full range, small and near the end of the range, where the lattice wraps.
+    template <uint32_t N>
+    void point(uint64_t& state, const uint32_t i, uint64_t (&p)[N]) noexcept {
+        for (uint32_t k = 0; k < N; ++k) {
+            const uint64_t r = splitmix64(state);
+            switch (i % 3) {
+            case 0: p[k] = r; break;
+            case 1: p[k] = r & 0xFFFF; break;
+            default: p[k] = UINT64_MAX - (r & 0xFFFF); break;
+            }
+        }
+    }
+
+    // value(cellSize, seed, p) over every cell size, seed and point.
+    template <uint32_t N, typename value_t>
+    uint64_t valueChecksum(value_t&& value) {
+        checksum_t sum;
+        uint64_t state = N;
+        for (const auto& cellSize : g_cellSizes) {
+            for (const uint32_t seed : g_seeds) {
+                for (uint32_t i = 0; i < g_points; ++i) {
+                    uint64_t p[N];
+                    point<N>(state, i, p);
+                    sum.add(value(cellSize, seed, p));
+                }
+            }
+        }
+        return sum.get();
+    }
+
+    template <uint32_t N>
+    auto named(const uint32_t (&cellSize)[4], const uint32_t seed) noexcept {
+        if constexpr (N == 1) {
+            return noise::int1d{ cellSize[0], seed };
+        }
+        else if constexpr (N == 2) {
+            return noise::int2d{ { cellSize[0], cellSize[1] }, seed };
+        }
+        else if constexpr (N == 3) {
+            return noise::int3d{ { cellSize[0], cellSize[1], cellSize[2] }, seed };
+        }
+        else {
+            return noise::int4d{ { cellSize[0], cellSize[1], cellSize[2], cellSize[3] }, seed };
+        }
+    }
+    template <uint32_t N>
+    noise::intNd<N> generic(const uint32_t (&cellSize)[4], const uint32_t seed) noexcept {
+        noise::intNd<N> noise;
+        std::copy(cellSize, cellSize + N, noise.cellSize);
+        noise.seed = seed;
+        return noise;
+    }
+
+    // noise.value(p[0], ..., p[N - 1])
+    template <uint32_t N, typename noise_t>
+    uint32_t valueAt(noise_t&& noise, const uint64_t (&p)[N]) {
+        return [&]<size_t... k>(std::index_sequence<k...>) {
+            return noise.value(p[k]...);
+        }(std::make_index_sequence<N>());
+    }
+    template <uint32_t N, typename noise_t>
+    uint32_t valueRawAt(const noise_t& noise, const uint64_t (&p)[N]) {
+        return [&]<size_t... k>(std::index_sequence<k...>) {
+            return noise.valueRaw(p[k]...);
+        }(std::make_index_sequence<N>());
+    }
+
+    void checkUniform() {
+        const uint32_t step = g_exhaustive ? 1 : g_uniformStep;
+        const uint64_t* expected = g_exhaustive ? g_uniformExhaustiveChecksums : g_uniformChecksums;
+        checksum_t sums[4];
+        for (uint64_t s = 0; s <= UINT32_MAX; s += step) {
+            sums[0].add(noise::uniform(noise::int1d::s_offsetLines, static_cast<uint32_t>(s)));
+            sums[1].add(noise::uniform(noise::int2d::s_offsetLines, static_cast<uint32_t>(s)));
+            sums[2].add(noise::uniform(noise::int3d::s_offsetLines, static_cast<uint32_t>(s)));
+            sums[3].add(noise::uniform(noise::int4d::s_offsetLines, static_cast<uint32_t>(s)));
+        }
+        for (uint32_t d = 0; d < 4; ++d) {
+            check(sums[d].get() == expected[d], "uniform checksum");
+        }
+    }
+
+    // The 5D table keeps value() of intNd<5> close to uniform and does not
+    // wrap near UINT32_MAX / 2, where it would collapse values to 0 and
+    // UINT32_MAX.
+    void checkUniformity5d() {
+        const noise::intNd<5> noise;
+        noise::thread_pool pool(1);
+        const auto count = noise::calibration::collect<5>(pool, UINT64_C(1) << 21,
+            noise::calibration::sampling_t(), [&](const uint64_t (&p)[5]) {
+                return noise.value(p);
+            });
+        const auto uniformity = noise::calibration::measure(count);
+        check(uniformity.maxDeviation < 0.35 && uniformity.rmsDeviation < 0.06,
+            "intNd<5>::value is close to uniform");
+    }
+
+    template <uint32_t bits>
+    bool monotone(const noise::quantile_table_t<bits>& table) {
+        bool ok = table.cdf[0] == 0 && table.cdf[table.knots - 1] == UINT32_MAX;
+        for (uint32_t i = 1; i < table.knots; ++i) {
+            ok &= table.cdf[i - 1] <= table.cdf[i];
+        }
+        return ok;
+    }
+
+    // Quantile tables of intNd<2> from the solved series and from collected
+    // statistics, and the batch mapping against the scalar one.
+    void checkQuantiles() {
+        const noise::intNd<2> noise;
+        noise::thread_pool pool(1);
+        const auto raw = [&](const uint64_t (&p)[2]) {
+            return noise.valueShifted(p);
+        };
+        static noise::quantile_table_t<12> solved;
+        noise::calibration::buildQuantiles(pool, noise::calibration::solveSeries(pool, noise.cellSize, 2), solved);
+        check(monotone(solved), "solved quantile knots are monotone from 0 to UINT32_MAX");
+        const auto count = noise::calibration::collect<2>(pool, UINT64_C(1) << 21,
+            noise::calibration::sampling_t(), [&](const uint64_t (&p)[2]) {
+                return noise::uniform(solved, raw(p));
+            });
+        const auto uniformity = noise::calibration::measure(count);
+        check(uniformity.maxDeviation < 0.08 && uniformity.rmsDeviation < 0.025,
+            "the solved quantile table is flat");
+
+        static noise::quantile_table_t<8> collected;
+        noise::calibration::buildQuantiles(noise::calibration::collect<2>(pool, UINT64_C(1) << 20,
+            noise::calibration::sampling_t(), raw), collected);
+        check(monotone(collected), "collected quantile knots are monotone from 0 to UINT32_MAX");
+
+        uint64_t state = 900;
+        std::vector<uint32_t> in = { 0, 1, UINT32_MAX / 2, UINT32_MAX / 2 + 1, UINT32_MAX - 1, UINT32_MAX };
+        for (uint32_t i = 0; i < 1000; ++i) {
+            in.push_back(static_cast<uint32_t>(splitmix64(state)));
+        }
+        std::vector<uint32_t> out(in.size());
+        bool same = true;
+        for (const size_t n : { in.size(), size_t(1), size_t(7) }) {
+            noise::uniform(solved, in.data(), out.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                same &= out[i] == noise::uniform(solved, in[i]);
+            }
+            noise::uniform(collected, in.data(), out.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                same &= out[i] == noise::uniform(collected, in[i]);
+            }
+        }
+        check(same, "uniform(quantile_table_t, in, out, count) equals the scalar one");
+        check(noise::uniform(solved, 0) == 0 && noise::uniform(solved, UINT32_MAX) >= solved.cdf[solved.knots - 2],
+            "the quantile table maps the ends of the range to its end knots");
+    }
+
+    // Adaptive segments of the offset curve of intNd<2>: ascending bounds, a
+    // monotone mapping without a wrap at the ends or at the fold, and
+    // uniform values.
+    void checkSegments() {
+        const noise::intNd<2> noise;
+        noise::thread_pool pool(1);
+        const auto offsets = noise::calibration::fitOffsets<6>(
+            noise::calibration::toHistogram(noise::calibration::solve(pool, 2, 64), 100'000'000));
+        double maxError = 0.0;
+        const auto segments = noise::calibration::buildSegments<32>(offsets, &maxError);
+        bool ordered = segments.begin[0] == 0;
+        size_t used = 1;
+        while (used < 32 && segments.begin[used] <= UINT32_MAX / 2) {
+            ordered &= segments.begin[used - 1] < segments.begin[used];
+            ++used;
+        }
+        ordered &= used < 32 && segments.begin[used] == UINT32_MAX / 2 + 1;
+        for (size_t i = used + 1; i < 32; ++i) {
+            ordered &= segments.begin[i] == UINT32_MAX;
+        }
+        check(ordered, "offset_segments_t bounds ascend from 0 to UINT32_MAX / 2 + 1");
+
+        bool monotone = true;
+        uint32_t last = noise::uniform(segments, 0);
+        const auto next = [&](const uint32_t s) {
+            const uint32_t u = noise::uniform(segments, s);
+            monotone &= last <= u;
+            last = u;
+        };
+        for (uint32_t s = 1; s < 1000; ++s) {
+            next(s);
+        }
+        for (uint64_t s = 1000; s < UINT32_MAX / 2 - 1000; s += 4099) {
+            next(static_cast<uint32_t>(s));
+        }
+        for (uint32_t s = UINT32_MAX / 2 - 1000; s < UINT32_MAX / 2 + 1000; ++s) {
+            next(s);
+        }
+        for (uint64_t s = UINT32_MAX / 2 + 1000; s < UINT32_MAX - 1000; s += 4099) {
+            next(static_cast<uint32_t>(s));
+        }
+        for (uint64_t s = UINT32_MAX - 1000; s <= UINT32_MAX; ++s) {
+            next(static_cast<uint32_t>(s));
+        }
+        check(monotone, "uniform(offset_segments_t, s) is monotone");
+        check(noise::uniform(segments, 0) < UINT32_MAX / 64 && noise::uniform(segments, UINT32_MAX) > UINT32_MAX / 64 * 63,
+            "uniform(offset_segments_t, s) does not wrap at the ends");
+
+        noise::offset_segments_t<32> tighter;
+        check(!noise::calibration::buildSegments(offsets, maxError / 2, tighter),
+            "buildSegments fails below the smallest max error");
+
+        const auto count = noise::calibration::collect<2>(pool, UINT64_C(1) << 21,
+            noise::calibration::sampling_t(), [&](const uint64_t (&p)[2]) {
+                return noise::uniform(segments, noise.valueShifted(p));
+            });
+        const auto uniformity = noise::calibration::measure(count);
+        check(uniformity.maxDeviation < 0.1 && uniformity.rmsDeviation < 0.03,
+            "the segmented table is flat");
+    }
+
+    bool near(const double a, const double b, const double tolerance) {
+        return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+    }
+
+    // SegmentedLinefit on a broken line far from 0: the exact lines back,
+    // continuous lines meeting at the knots on noisy points, and the fit of
+    // two shards merged equal to the fit of all points.
+    void checkLinefit() {
+        using fit_t = utils::SegmentedLinefit<double>;
+        const std::vector<double> knots = { 1e9, 1e9 + 1000, 1e9 + 2500, 1e9 + 3000, 1e9 + 4000 };
+        const double slopes[] = { 2.0, -1.0, 0.5, 3.0 };
+        std::vector<double> values = { 7.0 };
+        for (size_t i = 0; i < 4; ++i) {
+            values.push_back(values[i] + slopes[i] * (knots[i + 1] - knots[i]));
+        }
+        const auto line = [&](const double x) {
+            const size_t i = std::min<size_t>(std::upper_bound(knots.begin() + 1, knots.end() - 1, x) - knots.begin() - 1, 3);
+            return values[i] + slopes[i] * (x - knots[i]);
+        };
+
+        fit_t exact(knots);
+        for (double x = knots.front(); x < knots.back(); x += 7) {
+            exact.add(x, line(x));
+        }
+        bool same = true;
+        for (const auto& lines : { exact.lines(), exact.continuousLines() }) {
+            for (size_t i = 0; i < 4; ++i) {
+                same &= near(lines[i].slope, slopes[i], 1e-6);
+                same &= near(lines[i].slope * knots[i] + lines[i].intercept, values[i], 1e-6);
+            }
+        }
+        check(same, "SegmentedLinefit recovers a broken line");
+
+        uint64_t state = 1000;
+        fit_t all(knots);
+        fit_t shards[2] = { fit_t(knots), fit_t(knots) };
+        for (uint32_t i = 0; i < 4000; ++i) {
+            const double x = knots.front() + static_cast<double>(splitmix64(state) % 4000);
+            const double y = line(x) + static_cast<double>(splitmix64(state) % 2001) - 1000.0;
+            all.add(x, y);
+            shards[i % 2].add(x, y);
+        }
+        shards[0].merge(shards[1]);
+        const auto continuous = all.continuousLines();
+        bool meet = true;
+        for (size_t i = 1; i < 4; ++i) {
+            meet &= near(continuous[i - 1].slope * knots[i] + continuous[i - 1].intercept,
+                continuous[i].slope * knots[i] + continuous[i].intercept, 1e-6);
+        }
+        check(meet, "SegmentedLinefit::continuousLines meet at the knots");
+        same = true;
+        const auto pairs = { std::make_pair(all.lines(), shards[0].lines()),
+            std::make_pair(continuous, shards[0].continuousLines()) };
+        for (const auto& [a, b] : pairs) {
+            for (size_t i = 0; i < 4; ++i) {
+                same &= near(b[i].slope, a[i].slope, 1e-6);
+                same &= near(b[i].slope * knots[i] + b[i].intercept, a[i].slope * knots[i] + a[i].intercept, 1e-6);
+            }
+        }
+        check(same, "SegmentedLinefit::merge equals a single fit");
+
+        fit_t sparse(knots);
+        sparse.add(knots[0] + 10, 5.0);
+        sparse.add(knots[0] + 10, 7.0);
+        const auto lines = sparse.lines();
+        check(lines[0].slope == 0 && near(lines[0].slope * knots[0] + lines[0].intercept, 6.0, 1e-9)
+            && lines[1].slope == 0 && lines[1].intercept == 0,
+            "SegmentedLinefit gives a horizontal line for one x and a zero line for no points");
+        check(sparse.segment(0) == 0 && sparse.segment(knots[2]) == 2 && sparse.segment(2e9) == 3,
+            "SegmentedLinefit::segment clamps to the edge segments");
+    }
+
+    // Polyfit and PolyfitD merged from two shards against a single fit, and
+    // the batched Polynomial::y against the scalar one. The ISA builds cover
+    // the AVX2 path.
+    void checkPolyfit() {
+        const auto cubic = [](const double x) {
+            return 3.0 - 2.0 * x + 0.5 * x * x - 0.01 * x * x * x;
+        };
+        uint64_t state = 1100;
+        utils::Polyfit<double, 3> all;
+        utils::Polyfit<double, 3> shards[2];
+        utils::PolyfitD allD;
+        utils::PolyfitD shardsD[2];
+        allD.create(3);
+        shardsD[0].create(3);
+        shardsD[1].create(3);
+        for (uint32_t i = 0; i < 2000; ++i) {
+            const double x = static_cast<double>(splitmix64(state) % 100'000) / 1000.0;
+            const double y = cubic(x) + static_cast<double>(splitmix64(state) % 1001) / 1000.0 - 0.5;
+            all.add(x, y);
+            shards[i % 2].add(x, y);
+            allD.add(x, y);
+            shardsD[i % 2].add(x, y);
+        }
+        shards[0].merge(shards[1]);
+        shardsD[0].merge(shardsD[1]);
+        const auto weights = all.weights();
+        const auto merged = shards[0].weights();
+        const auto weightsD = allD.weights();
+        const auto mergedD = shardsD[0].weights();
+        bool same = weightsD.size() == 4 && mergedD.size() == 4;
+        for (size_t i = 0; i < 4 && same; ++i) {
+            same &= near(merged[i], weights[i], 1e-6);
+            same &= near(weightsD[i], weights[i], 1e-6);
+            same &= near(mergedD[i], weights[i], 1e-6);
+        }
+        check(same, "Polyfit::merge and PolyfitD::merge equal a single fit");
+        check(near(weights[3], -0.01, 1e-2) && near(weights[2], 0.5, 1e-2),
+            "Polyfit recovers a cubic");
+
+        const auto polynomial = all.polynomial();
+        std::vector<double> xs(13);
+        for (size_t i = 0; i < xs.size(); ++i) {
+            xs[i] = static_cast<double>(i) * 7.5 - 3.0;
+        }
+        same = polynomial.weights() == weights;
+        for (size_t n = 0; n <= xs.size(); ++n) {
+            std::vector<double> ys(n, -1.0);
+            polynomial.y(std::span<const double>(xs.data(), n), ys);
+            for (size_t i = 0; i < n; ++i) {
+                same &= near(ys[i], polynomial.y(xs[i]), 1e-12) && near(ys[i], all.y(xs[i]), 1e-12)
+                    && near(ys[i], allD.y(xs[i]), 1e-6);
+            }
+        }
+        std::vector<double> inPlace = xs;
+        polynomial.y(inPlace, inPlace);
+        for (size_t i = 0; i < xs.size(); ++i) {
+            same &= near(inPlace[i], polynomial.y(xs[i]), 1e-12);
+        }
+        check(same, "Polynomial::y(xs, ys) equals the scalar y");
+    }
+
+    // The solved bins against the collected histogram of the raw value, bin by
+    // bin within 5 standard deviations of the Monte-Carlo count.
+    template <uint32_t N>
+    void checkSolver(noise::thread_pool& pool) {
+        constexpr uint64_t reps = UINT64_C(1) << 22;
+        const auto bins = noise::calibration::solve(pool, N, 64);
+        const noise::intNd<N> noise;
+        const auto count = noise::calibration::collect<N>(pool, reps,
+            noise::calibration::sampling_t(), [&](const uint64_t (&p)[N]) {
+                return N == 1 ? noise.valueRaw(p) : noise.valueShifted(p);
+            });
+        bool close = true;
+        for (size_t b = 0; b < bins.size(); ++b) {
+            const double expected = bins[b] * reps;
+            close &= std::abs(count[b] - expected) < 5.0 * std::sqrt(expected);
+        }
+        check(close, "calibration::solve agrees with collect");
+    }
+
+    // solveTable reproduces the built-in tables of cellSize 64.
+    template <uint32_t N>
+    void checkSolvedTable(noise::thread_pool& pool) {
+        uint32_t cellSizes[N];
+        std::fill(cellSizes, cellSizes + N, 64);
+        const auto table = noise::calibration::solveTable(pool, cellSizes, N);
+        uint32_t maxDiff = 0;
+        for (uint64_t s = 0; s <= UINT32_MAX; s += 65537) {
+            const uint32_t a = noise::uniform(table.lines, static_cast<uint32_t>(s));
+            const uint32_t b = noise::uniform(noise::intNd<N>::offsetLines(), static_cast<uint32_t>(s));
+            maxDiff = std::max(maxDiff, a > b ? a - b : b - a);
+        }
+        check(maxDiff < UINT32_MAX / 500, "calibration::solveTable reproduces the built-in table");
+    }
+
+    void checkSolver() {
+        noise::thread_pool one(1);
+        noise::thread_pool three(3);
+        checkSolver<1>(one);
+        checkSolver<2>(one);
+        const uint32_t cellSizes[] = { 64, 3, 1000 };
+        check(noise::calibration::solveSeries(one, cellSizes, 3)
+            == noise::calibration::solveSeries(three, cellSizes, 3),
+            "calibration::solveSeries does not depend on the threads");
+        checkSolvedTable<1>(one);
+        checkSolvedTable<2>(one);
+        checkSolvedTable<3>(one);
+        checkSolvedTable<4>(one);
+    }
+
+    // table_cache saved to a file and loaded by another cache, and the files
+    // of another format.
+    void checkTableCache() {
+        const std::string path = (std::filesystem::temp_directory_path()
+            / "simple-uniform-noise-test.cache").string();
+        std::remove(path.c_str());
+        const noise::int1d n1{ 5, 0 };
+        const noise::int2d n2{ { 64, 3 }, 0 };
+        noise::calibration::table_t saved[2];
+        {
+            noise::table_cache cache;
+            check(cache.open(path), "table_cache opens a missing file");
+            saved[0] = cache.get(n1);
+            saved[1] = cache.get(n2);
+            const noise::calibrated<noise::int2d> calibrated(n2, cache);
+            check(calibrated.value(UINT64_C(12345), UINT64_C(678))
+                == noise::uniform(saved[1].lines, n2.valueShifted(12345, 678)),
+                "calibrated<int2d> maps valueShifted through the cached table");
+        }
+        {
+            noise::table_cache cache;
+            check(cache.open(path), "table_cache opens its file");
+            // The key is the sorted cell sizes.
+            const noise::int2d swapped{ { 3, 64 }, 0 };
+            check(std::memcmp(&cache.get(n1), &saved[0], sizeof(saved[0])) == 0
+                && std::memcmp(&cache.get(swapped), &saved[1], sizeof(saved[1])) == 0,
+                "table_cache loads the saved tables bit-identical");
+        }
+
+        // A table that the solver would not produce is served from the file.
+        noise::calibration::table_t marked;
+        for (uint32_t i = 0; i < noise::calibration::g_offsetLines; ++i) {
+            marked.lines[i] = { i, -static_cast<int64_t>(i) };
+        }
+        const auto write = [&](const char (&magic)[5], const uint32_t version, const uint32_t count) {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            const uint32_t dims = 1;
+            const uint32_t cellSize = 7;
+            file.write(magic, 4);
+            file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            if (count != 0) {
+                file.write(reinterpret_cast<const char*>(&dims), sizeof(dims));
+                file.write(reinterpret_cast<const char*>(&cellSize), sizeof(cellSize));
+                file.write(reinterpret_cast<const char*>(marked.lines), sizeof(marked.lines));
+            }
+        };
+        {
+            noise::table_cache cache;
+            write("SUNT", 1, 1);
+            check(cache.open(path), "table_cache opens a written cache");
+            check(std::memcmp(&cache.get(noise::int1d{ 7, 0 }), &marked, sizeof(marked)) == 0,
+                "table_cache serves the tables of its file");
+        }
+        noise::table_cache cache;
+        write("SUNX", 1, 0);
+        check(!cache.open(path), "table_cache rejects a wrong magic");
+        write("SUNT", 2, 0);
+        check(!cache.open(path), "table_cache rejects a wrong version");
+        write("SUNT", 1, 2);
+        check(!cache.open(path), "table_cache rejects a truncated file");
+        std::remove(path.c_str());
+    }
+
+    template <uint32_t N>
+    void checkValues() {
+        check(valueChecksum<N>([](const uint32_t (&cellSize)[4], const uint32_t seed, const uint64_t (&p)[N]) {
+            return valueAt<N>(named<N>(cellSize, seed), p);
+        }) == g_valueChecksums[N - 1], "value checksum");
+        check(valueChecksum<N>([](const uint32_t (&cellSize)[4], const uint32_t seed, const uint64_t (&p)[N]) {
+            return valueRawAt<N>(named<N>(cellSize, seed), p);
+        }) == g_valueRawChecksums[N - 1], "valueRaw checksum");
+
+        // The generic engine, prepared and locality_t, and values() in blocks.
+        uint64_t state = 100 + N;
+        for (const auto& cellSize : g_cellSizes) {
+            for (const uint32_t seed : g_seeds) {
+                const auto noise = named<N>(cellSize, seed);
+                const auto nd = generic<N>(cellSize, seed);
+                const typename decltype(noise)::prepared prepared(noise);
+                typename decltype(noise)::locality_t locality(noise);
+                std::vector<uint64_t> points(g_points * N);
+                std::vector<uint32_t> expected(g_points);
+                bool same = true;
+                for (uint32_t i = 0; i < g_points; ++i) {
+                    uint64_t (&p)[N] = *reinterpret_cast<uint64_t (*)[N]>(points.data() + i * N);
+                    point<N>(state, i, p);
+                    expected[i] = valueAt<N>(noise, p);
+                    same &= valueAt<N>(nd, p) == expected[i];
+                    same &= valueAt<N>(prepared, p) == expected[i];
+                    same &= valueAt<N>(locality, p) == expected[i];
+                }
+                check(same, "intNd, prepared and locality_t equal value()");
+
+                // A short random walk, mostly inside the same and the neighbour cells.
+                uint64_t p[N];
+                point<N>(state, 0, p);
+                same = true;
+                for (uint32_t i = 0; i < g_points; ++i) {
+                    const uint64_t r = splitmix64(state);
+                    const uint32_t k = r % N;
+                    const uint64_t step = (r >> 8) % 3 + 1;
+                    p[k] = (r >> 16) & 1 ? p[k] + step : p[k] - step;
+                    same &= valueAt<N>(locality, p) == valueAt<N>(noise, p);
+                }
+                check(same, "locality_t walk equals value()");
+
+                std::vector<uint32_t> out(g_points);
+                nd.values(reinterpret_cast<const uint64_t (*)[N]>(points.data()), g_points, out.data());
+                check(out == expected, "intNd::values equals value()");
+            }
+        }
+    }
+
+    // The compile-time forms against the runtime ones.
+    template <typename basic_t, typename noise_t, uint32_t N>
+    void checkBasic(const noise_t& noise) {
+        const basic_t basic;
+        uint64_t state = 200 + N;
+        bool same = true;
+        for (uint32_t i = 0; i < g_points; ++i) {
+            uint64_t p[N];
+            point<N>(state, i, p);
+            same &= valueAt<N>(basic, p) == valueAt<N>(noise, p);
+        }
+        check(same, "basic_int*d equals value()");
+    }
+
+    void checkCursor() {
+        uint64_t state = 300;
+        for (const auto& cellSize : g_cellSizes) {
+            const noise::int1d noise{ cellSize[0], g_seeds[1] };
+            const uint64_t begins[] = { 0, splitmix64(state), UINT64_MAX - 1000 };
+            for (const uint64_t x0 : begins) {
+                std::vector<uint32_t> out(2000);
+                noise.generate(x0, out.size(), out.data());
+                bool same = true;
+                for (size_t i = 0; i < out.size(); ++i) {
+                    same &= out[i] == noise.value(x0 + i);
+                }
+                check(same, "int1d::generate equals value()");
+            }
+        }
+    }
+
+    void checkHashes() {
+        uint64_t state = 400;
+        std::vector<uint64_t> keys(64 * 4);
+        for (uint64_t& key : keys) {
+            key = splitmix64(state);
+        }
+        uint32_t out[64];
+        bool same = true;
+        for (size_t count = 0; count <= 64; ++count) {
+            utils::MurmurHash3_x32_32_batch<1>(keys.data(), count, 7, out);
+            for (size_t i = 0; i < count; ++i) {
+                same &= out[i] == utils::MurmurHash3_x32_32(keys.data() + i, 8, 7);
+            }
+            utils::MurmurHash3_x32_32_batch<2>(keys.data(), count, 7, out);
+            for (size_t i = 0; i < count; ++i) {
+                same &= out[i] == utils::MurmurHash3_x32_32(keys.data() + i * 2, 16, 7);
+            }
+            utils::MurmurHash3_x32_32_batch<3>(keys.data(), count, 7, out);
+            for (size_t i = 0; i < count; ++i) {
+                same &= out[i] == utils::MurmurHash3_x32_32(keys.data() + i * 3, 24, 7);
+            }
+            utils::MurmurHash3_x32_32_batch<4>(keys.data(), count, 7, out);
+            for (size_t i = 0; i < count; ++i) {
+                same &= out[i] == utils::MurmurHash3_x32_32(keys.data() + i * 4, 32, 7);
+            }
+        }
+        check(same, "MurmurHash3_x32_32_batch equals MurmurHash3_x32_32");
+
+        const uint64_t lo[4] = { keys[0], keys[1], keys[2], keys[3] };
+        const uint64_t hi[4] = { keys[4], keys[5], keys[6], keys[7] };
+        uint32_t prefix[16];
+        utils::MurmurHash3_x32_32_prefix<4>(lo, hi, 9, prefix);
+        same = true;
+        for (uint32_t c = 0; c < 16; ++c) {
+            uint64_t key[4];
+            for (uint32_t k = 0; k < 4; ++k) {
+                key[k] = (c >> k) & 1 ? hi[k] : lo[k];
+            }
+            same &= prefix[c] == utils::MurmurHash3_x32_32(key, sizeof(key), 9);
+        }
+        check(same, "MurmurHash3_x32_32_prefix equals MurmurHash3_x32_32");
+    }
+
+    void checkDivider() {
+        uint64_t state = 500;
+        std::vector<uint64_t> divisors = { 1, 2, 3, 5, 7, 63, 64, 65, 100, 4103,
+            UINT32_MAX - 1, UINT32_MAX, UINT64_C(1) << 32, UINT64_C(1) << 63, UINT64_MAX };
+        for (uint32_t i = 0; i < 32; ++i) {
+            divisors.push_back(splitmix64(state) >> (i % 64));
+        }
+        bool same = true;
+        for (const uint64_t d : divisors) {
+            if (d == 0) {
+                continue;
+            }
+            const utils::divider_u64 divider(d);
+            const uint64_t edges[] = { 0, 1, d - 1, d, d + 1, UINT64_MAX - 1, UINT64_MAX };
+            for (const uint64_t n : edges) {
+                same &= divider.divide(n) == n / d;
+            }
+            for (uint32_t i = 0; i < 256; ++i) {
+                const uint64_t n = splitmix64(state);
+                same &= divider.divide(n) == n / d;
+            }
+        }
+        check(same, "divider_u64 equals the division");
+    }
+
+    void checkStream64() {
+        constexpr size_t count = 1000;
+        bool same = true;
+        for (const uint64_t seed : g_seeds) {
+            utils::stream64 stream(seed);
+            std::vector<uint64_t> sequential(count + 3);
+            for (uint64_t& v : sequential) {
+                v = stream();
+            }
+            std::vector<uint64_t> filled(count);
+            utils::stream64 other(seed);
+            other.seek(3);
+            other.fill(filled.data(), count);
+            same &= std::equal(filled.begin(), filled.end(), sequential.begin() + 3);
+            same &= other.position() == count + 3;
+
+            utils::stream64 split = utils::stream64(seed, 2).split(1);
+            utils::stream64 seeked(seed);
+            seeked.seek(utils::stream64::s_streamLength);
+            same &= split() == seeked();
+
+            // The seed is a key: the next seed is not the same stream shifted.
+            utils::stream64 next(seed + 1);
+            std::vector<uint64_t> values(count);
+            next.fill(values.data(), count);
+            std::sort(sequential.begin(), sequential.end());
+            for (const uint64_t v : values) {
+                same &= !std::binary_search(sequential.begin(), sequential.end(), v);
+            }
+        }
+        check(same, "stream64 fill, seek, split and seeds");
+    }
+
+    // Compares a width x height plane with value(x0 + col, y0 + row, rest...).
+    template <typename noise_t, typename... rest_t>
+    bool samePlane(const noise_t& noise, const uint32_t* out, const size_t stride,
+            const uint64_t x0, const uint64_t y0, const uint32_t width, const uint32_t height,
+            const rest_t... rest) {
+        bool same = true;
+        for (uint32_t row = 0; row < height; ++row) {
+            for (uint32_t col = 0; col < width; ++col) {
+                same &= out[row * stride + col] == noise.value(x0 + col, y0 + row, rest...);
+            }
+        }
+        return same;
+    }
+
+    constexpr uint32_t g_width = 37;
+    constexpr uint32_t g_height = 23;
+    constexpr size_t g_stride = 40;
+
+    // Origins of the regions, the last two wrap around.
+    std::vector<uint64_t> origins(uint64_t& state) {
+        return { 0, splitmix64(state) >> 24, splitmix64(state), UINT64_MAX - 20 };
+    }
+
+    // value(p, fields) of intNd and prepared against value(p). 1D is not
+    // shifted, so intNd<1> takes no shifts.
+    template <typename noise_t, uint32_t N>
+    concept shiftable = requires(const noise_t& noise, const uint64_t (&p)[N],
+            const typename noise::intNd<N>::shifts& fields) {
+        noise.value(p, fields);
+    };
+    static_assert(!shiftable<noise::intNd<1>, 1> && !shiftable<noise::intNd<1>::prepared, 1>);
+    static_assert(shiftable<noise::intNd<2>, 2> && shiftable<noise::intNd<2>::prepared, 2>);
+
+    template <uint32_t N>
+    void checkShifts() {
+        uint64_t state = 800 + N;
+        constexpr uint32_t size = 7;
+        for (const auto& cellSize : g_cellSizes) {
+            noise::intNd<N> noise;
+            for (uint32_t k = 0; k < N; ++k) {
+                noise.cellSize[k] = cellSize[k % 4];
+            }
+            noise.seed = g_seeds[1];
+            const typename noise::intNd<N>::prepared prepared(noise);
+            for (const uint64_t origin : origins(state)) {
+                uint64_t begin[N];
+                uint32_t sizes[N];
+                for (uint32_t k = 0; k < N; ++k) {
+                    begin[k] = origin ^ (k * 0x1000);
+                    sizes[k] = size;
+                }
+                const typename noise::intNd<N>::shifts fields(noise.cellSize, begin, sizes);
+                bool same = true;
+                for (uint32_t i = 0; i < 64; ++i) {
+                    uint64_t p[N];
+                    for (uint32_t k = 0; k < N; ++k) {
+                        p[k] = begin[k] + splitmix64(state) % size;
+                    }
+                    const uint32_t expected = noise.value(p);
+                    same &= noise.value(p, fields) == expected;
+                    same &= prepared.value(p, fields) == expected;
+                    same &= noise.valueShifted(p, fields) == noise.valueShifted(p);
+                }
+                check(same, "intNd::value(p, shifts) equals value(p)");
+            }
+        }
+    }
+
+    void checkPlanes() {
+        uint64_t state = 600;
+        std::vector<uint32_t> out(g_stride * g_height);
+        for (const auto& cellSize : g_cellSizes) {
+            const auto n2 = named<2>(cellSize, g_seeds[1]);
+            const auto n3 = named<3>(cellSize, g_seeds[1]);
+            const auto n4 = named<4>(cellSize, g_seeds[1]);
+            for (const uint64_t x0 : origins(state)) {
+                for (const uint64_t y0 : origins(state)) {
+                    n2.fill(x0, y0, g_width, g_height, out.data(), g_stride);
+                    check(samePlane(n2, out.data(), g_stride, x0, y0, g_width, g_height),
+                        "int2d::fill equals value()");
+
+                    const noise::int2d::shifts fields2(n2.cellSize, x0, y0, g_width, g_height);
+                    const noise::int3d::shifts fields3(n3.cellSize, x0, y0, x0, g_width, g_height, 2);
+                    const noise::int4d::shifts fields4(n4.cellSize, x0, y0, x0, y0, g_width, g_height, 2, 2);
+                    bool same = true;
+                    for (uint32_t row = 0; row < g_height; row += 5) {
+                        for (uint32_t col = 0; col < g_width; col += 3) {
+                            const uint64_t x = x0 + col;
+                            const uint64_t y = y0 + row;
+                            same &= n2.value(x, y, fields2) == n2.value(x, y);
+                            same &= n3.value(x, y, x0 + 1, fields3) == n3.value(x, y, x0 + 1);
+                            same &= n4.value(x, y, x0 + 1, y0, fields4) == n4.value(x, y, x0 + 1, y0);
+                        }
+                    }
+                    check(same, "shifts equal value()");
+
+                    for (const uint64_t z : origins(state)) {
+                        n3.slice(z).fill(x0, y0, g_width, g_height, out.data(), g_stride);
+                        check(samePlane(n3, out.data(), g_stride, x0, y0, g_width, g_height, z),
+                            "int3d::slice_t::fill equals value()");
+                        check(n3.slice(z).value(x0, y0) == n3.value(x0, y0, z),
+                            "int3d::slice_t::value equals value()");
+
+                        const uint64_t w = z ^ x0;
+                        n4.slice(z, w).fill(x0, y0, g_width, g_height, out.data(), g_stride);
+                        check(samePlane(n4, out.data(), g_stride, x0, y0, g_width, g_height, z, w),
+                            "int4d::slice_t::fill equals value()");
+                        check(n4.slice(z, w).value(x0, y0) == n4.value(x0, y0, z, w),
+                            "int4d::slice_t::value equals value()");
+                    }
+                }
+            }
+        }
+    }
+
+    void checkStreams(const uint32_t (&cellSize)[4], uint64_t& state, std::vector<uint32_t>& out) {
+        const auto n3 = named<3>(cellSize, g_seeds[1]);
+        const auto n4 = named<4>(cellSize, g_seeds[1]);
+        for (const uint64_t x0 : origins(state)) {
+            const uint64_t y0 = splitmix64(state) >> 32;
+            for (const uint64_t z0 : origins(state)) {
+                // Up to the wrap of z from UINT64_MAX to 0.
+                auto slab = n3.slab(x0, y0, g_width, g_height, z0 - 5);
+                bool same = true;
+                for (uint32_t i = 0; i < 24; ++i) {
+                    const uint64_t z = slab.z();
+                    slab.next(out.data(), g_stride);
+                    same &= samePlane(n3, out.data(), g_stride, x0, y0, g_width, g_height, z);
+                }
+                check(same, "int3d::slab_t::next equals value()");
+
+                // Forward, a jump back and far away.
+                auto animation = n4.animation(x0, y0, g_width, g_height, z0);
+                const uint64_t w0 = splitmix64(state);
+                same = true;
+                for (uint32_t i = 0; i < 24; ++i) {
+                    const uint64_t w = i < 16 ? x0 - 8 + i : i < 20 ? w0 - i : w0 + i * 1000;
+                    animation.fill(w, out.data(), g_stride);
+                    same &= samePlane(n4, out.data(), g_stride, x0, y0, g_width, g_height, z0, w);
+                }
+                check(same, "int4d::animation_t::fill equals value()");
+            }
+        }
+    }
+    void checkStreams() {
+        uint64_t state = 700;
+        std::vector<uint32_t> out(g_stride * g_height);
+        for (const auto& cellSize : g_cellSizes) {
+            checkStreams(cellSize, state, out);
+        }
+        for (const auto& cellSize : g_thinCellSizes) {
+            checkStreams(cellSize, state, out);
+        }
+    }
+
+    // Regions wide enough for the shift of x to span many z and w cells: the
+    // slab and animation rings near their plane limit, and the per-sample
+    // fallback beyond it.
+    void checkRings() {
+        constexpr uint32_t width = 1200;
+        constexpr uint32_t height = 2;
+        // 16 planes, the limit, and 66 planes
+        constexpr uint32_t cellSizes[][4] = {
+            { 224, 64, 8, 8 },
+            { 1024, 64, 2, 2 },
+        };
+        uint64_t state = 750;
+        std::vector<uint32_t> out(width * height);
+        for (const auto& cellSize : cellSizes) {
+            const auto n3 = named<3>(cellSize, g_seeds[1]);
+            const auto n4 = named<4>(cellSize, g_seeds[1]);
+            const uint64_t x0 = splitmix64(state) >> 24;
+            const uint64_t y0 = splitmix64(state) >> 24;
+            const uint64_t z0 = splitmix64(state) >> 24;
+            auto slab = n3.slab(x0, y0, width, height, z0);
+            bool same = true;
+            for (uint32_t i = 0; i < 12; ++i) {
+                const uint64_t z = slab.z();
+                slab.next(out.data(), width);
+                same &= samePlane(n3, out.data(), width, x0, y0, width, height, z);
+            }
+            check(same, "int3d::slab_t::next of a wide region equals value()");
+
+            auto animation = n4.animation(x0, y0, width, height, z0);
+            same = true;
+            for (uint32_t i = 0; i < 12; ++i) {
+                animation.fill(x0 + i, out.data(), width);
+                same &= samePlane(n4, out.data(), width, x0, y0, width, height, z0, x0 + i);
+            }
+            check(same, "int4d::animation_t::fill of a wide region equals value()");
+        }
+    }
+
+    // The same output for any number of threads.
+    void checkParallel() {
+        constexpr uint32_t width = 150;
+        constexpr uint32_t height = 70;
+        constexpr uint32_t depth = 3;
+        constexpr uint32_t length = 2;
+        const noise::int2d n2{ { 64, 3 }, 5 };
+        const noise::int3d n3{ { 64, 3, 1000 }, 5 };
+        const noise::int4d n4{ { 64, 3, 1000, 2 }, 5 };
+        const uint64_t x0 = UINT64_C(1) << 40;
+        const uint64_t y0 = 12345;
+        const uint64_t z0 = 777;
+        const uint64_t w0 = UINT64_MAX - 1;
+        for (const uint32_t threads : { 1u, 2u, 5u }) {
+            noise::thread_pool pool(threads);
+            std::vector<uint32_t> out(size_t(width) * height * depth * length);
+            noise::parallel_fill(pool, n2, x0, y0, width, height, out.data(), width);
+            check(samePlane(n2, out.data(), width, x0, y0, width, height), "parallel_fill int2d");
+
+            noise::parallel_fill(pool, n3, x0, y0, z0, width, height, depth,
+                out.data(), width, size_t(width) * height);
+            bool same = true;
+            for (uint32_t z = 0; z < depth; ++z) {
+                same &= samePlane(n3, out.data() + z * width * height, width,
+                    x0, y0, width, height, z0 + z);
+            }
+            check(same, "parallel_fill int3d");
+
+            noise::parallel_fill(pool, n4, x0, y0, z0, w0, width, height, depth, length,
+                out.data(), width, size_t(width) * height, size_t(width) * height * depth);
+            same = true;
+            for (uint32_t w = 0; w < length; ++w) {
+                for (uint32_t z = 0; z < depth; ++z) {
+                    same &= samePlane(n4, out.data() + (w * depth + z) * width * height, width,
+                        x0, y0, width, height, z0 + z, w0 + w);
+                }
+            }
+            check(same, "parallel_fill int4d");
+        }
+
+        const noise::intNd<2> noise;
+        const auto sample = [&](const uint64_t (&p)[2]) {
+            return noise.value(p);
+        };
+        for (const auto sequence : { noise::calibration::sequence_t::random, noise::calibration::sequence_t::sobol }) {
+            noise::calibration::sampling_t sampling;
+            sampling.sequence = sequence;
+            noise::thread_pool one(1);
+            noise::thread_pool three(3);
+            const uint64_t reps = (UINT64_C(5) << 20) / 2;
+            check(noise::calibration::collect<2>(one, reps, sampling, sample)
+                == noise::calibration::collect<2>(three, reps, sampling, sample),
+                "calibration::collect does not depend on the threads");
+        }
+    }
+
+    // The CPU must support what the compiler was allowed to use.
+    bool supported() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# if defined(__AVX512F__)
+        if (!__builtin_cpu_supports("avx512f")) {
+            return false;
+        }
+# endif
+# if defined(__AVX512DQ__)
+        if (!__builtin_cpu_supports("avx512dq")) {
+            return false;
+        }
+# endif
+# if defined(__AVX2__)
+        if (!__builtin_cpu_supports("avx2")) {
+            return false;
+        }
+# endif
+# if defined(__SSE4_1__)
+        if (!__builtin_cpu_supports("sse4.1")) {
+            return false;
+        }
+# endif
+#endif
+        return true;
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (!supported()) {
+        std::printf("Skipped, the CPU does not support the instruction set.\n");
+        return 77;
+    }
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--exhaustive") == 0) {
+            g_exhaustive = true;
+        }
+        else {
+            std::printf("Usage: %s [--exhaustive]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    checkUniform();
+    checkValues<1>();
+    checkValues<2>();
+    checkValues<3>();
+    checkValues<4>();
+    checkUniformity5d();
+    checkQuantiles();
+    checkSegments();
+    checkLinefit();
+    checkPolyfit();
+    checkSolver();
+    checkTableCache();
+    checkBasic<noise::basic_int1d<64>, noise::int1d, 1>(noise::int1d{ 64, 0 });
+    checkBasic<noise::basic_int1d<3, 5>, noise::int1d, 1>(noise::int1d{ 3, 5 });
+    checkBasic<noise::basic_int2d<64, 3>, noise::int2d, 2>(noise::int2d{ { 64, 3 }, 0 });
+    checkBasic<noise::basic_int3d<64, 64, 64>, noise::int3d, 3>(noise::int3d{ { 64, 64, 64 }, 0 });
+    checkBasic<noise::basic_int3d<2, 1000, 7, 5>, noise::int3d, 3>(noise::int3d{ { 2, 1000, 7 }, 5 });
+    checkBasic<noise::basic_int4d<64, 64, 64, 64>, noise::int4d, 4>(noise::int4d{ { 64, 64, 64, 64 }, 0 });
+    checkBasic<noise::basic_int4d<64, 3, 1000, 2, 5>, noise::int4d, 4>(noise::int4d{ { 64, 3, 1000, 2 }, 5 });
+    checkCursor();
+    checkHashes();
+    checkDivider();
+    checkStream64();
+    checkShifts<2>();
+    checkShifts<3>();
+    checkShifts<4>();
+    checkShifts<5>();
+    checkPlanes();
+    checkStreams();
+    checkRings();
+    checkParallel();
+
+    if (g_failures != 0) {
+        std::printf("%" PRIu32 " checks failed.\n", g_failures);
+        return 1;
+    }
+    std::printf("All checks passed.\n");
+    return 0;
+}
@@ -2,36 +2,38 @@
 #ifndef SIMPLE_UNIFORM_NOISE_STAFF
 #define SIMPLE_UNIFORM_NOISE_STAFF
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
+#if __cplusplus >= 202002L
+#   include <span>
+#endif
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_1__)
+#   include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__SIZEOF_INT128__)
+#   include <intrin.h>
+#endif
 
 namespace utils {
 
-#ifdef __GNUG__
-#   define SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-#endif
-
-#ifdef SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-# pragma GCC push_options
-# pragma GCC optimize ("O0")
-#endif
 inline uint64_t MurmurHash2_x64_64A(
         const void* key, const uint64_t len, const uint64_t seed) {
-#ifdef SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-# pragma GCC pop_options
-#endif
     constexpr uint64_t m = UINT64_C(0xC6A4A7935BD1E995);
     constexpr uint64_t r = 47;
     uint64_t h = seed ^ (len * m);
-    const uint64_t* data = static_cast<const uint64_t*>(key);
-    const uint64_t* end = data + (len >> 3);
+    const uint8_t* data = static_cast<const uint8_t*>(key);
+    const uint8_t* end = data + (len & ~UINT64_C(7));
     while (data != end) {
-        uint64_t k = *data++;
+        uint64_t k;
+        std::memcpy(&k, data, sizeof(k));
+        data += sizeof(k);
         k *= m;
         k ^= k >> r;
         k *= m;
         h ^= k;
         h *= m;
     }
-    const uint8_t* tail = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* tail = data;
     switch (len & 7) {
     case 7: h ^= static_cast<uint64_t>(tail[6]) << 48; [[fallthrough]];
     case 6: h ^= static_cast<uint64_t>(tail[5]) << 40; [[fallthrough]];
@@ -47,15 +49,8 @@ inline uint64_t MurmurHash2_x64_64A(
     h ^= h >> r;
     return h;
 }
-#ifdef SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-# pragma GCC push_options
-# pragma GCC optimize ("O0")
-#endif
 inline constexpr uint64_t MurmurHash2_x64_64A(
         const uint64_t key, const uint64_t seed) {
-#ifdef SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-# pragma GCC pop_options
-#endif
     constexpr uint64_t m = UINT64_C(0xC6A4A7935BD1E995);
     constexpr uint64_t m8 = sizeof(key) * UINT64_C(0xC6A4A7935BD1E995);
     constexpr uint64_t r = 47;
@@ -72,29 +67,24 @@ inline constexpr uint64_t MurmurHash2_x64_64A(
     return h;
 }
 
-#ifdef SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-# pragma GCC push_options
-# pragma GCC optimize ("O0")
-#endif
 inline uint32_t MurmurHash2_x32_32A(
         const void* key, const uint32_t len, const uint32_t seed) {
-#ifdef SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-# pragma GCC pop_options
-#endif
     constexpr uint32_t m = 0x5BD1E995;
     constexpr uint32_t r = 24;
     uint32_t h = seed;
-    const uint32_t* data = static_cast<const uint32_t*>(key);
-    const uint32_t* end = data + (len >> 2);
+    const uint8_t* data = static_cast<const uint8_t*>(key);
+    const uint8_t* end = data + (len & ~3u);
     while (data != end) {
-        uint32_t k = *data++;
+        uint32_t k;
+        std::memcpy(&k, data, sizeof(k));
+        data += sizeof(k);
         k *= m;
         k ^= k >> r;
         k *= m;
         h *= m;
         h ^= k;
     }
-    const uint8_t* tail = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* tail = data;
     uint32_t t = 0;
     switch (len & 3) {
     case 3: t ^= static_cast<uint32_t>(tail[2]) << 16; [[fallthrough]];
@@ -113,30 +103,64 @@ inline uint32_t MurmurHash2_x32_32A(
     return h;
 }
 
-#ifdef SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-# pragma GCC push_options
-# pragma GCC optimize ("O0")
+namespace detail {
+
+inline constexpr uint32_t MurmurHash3_x32_32_round(uint32_t h1, uint32_t k1) noexcept {
+    constexpr uint32_t c1 = 0xCC9E2D51;
+    constexpr uint32_t c2 = 0x1B873593;
+    k1 *= c1;
+    k1 = (k1 << 15) | (k1 >> (32 - 15));
+    k1 *= c2;
+    h1 ^= k1;
+    h1 = (h1 << 13) | (h1 >> (32 - 13));
+    h1 = h1 * 5 + 0xE6546B64;
+    return h1;
+}
+// Two rounds over the uint64_t word in its memory order.
+inline constexpr uint32_t MurmurHash3_x32_32_mix(uint32_t h1, const uint64_t k) noexcept {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    h1 = MurmurHash3_x32_32_round(h1, static_cast<uint32_t>(k >> 32));
+    h1 = MurmurHash3_x32_32_round(h1, static_cast<uint32_t>(k));
+#else
+    h1 = MurmurHash3_x32_32_round(h1, static_cast<uint32_t>(k));
+    h1 = MurmurHash3_x32_32_round(h1, static_cast<uint32_t>(k >> 32));
 #endif
+    return h1;
+}
+inline constexpr uint32_t MurmurHash3_x32_32_final(uint32_t h1, const uint32_t len) noexcept {
+    h1 ^= len;
+    h1 ^= h1 >> 16;
+    h1 *= 0x85EBCA6B;
+    h1 ^= h1 >> 13;
+    h1 *= 0xC2B2AE35;
+    h1 ^= h1 >> 16;
+    return h1;
+}
+template <uint32_t words>
+inline constexpr uint32_t MurmurHash3_x32_32_words(const uint64_t* key, const uint32_t seed) noexcept {
+    uint32_t h1 = seed;
+    for (uint32_t w = 0; w < words; ++w) {
+        h1 = MurmurHash3_x32_32_mix(h1, key[w]);
+    }
+    return MurmurHash3_x32_32_final(h1, words * sizeof(uint64_t));
+}
+
+} // namespace detail
+
 inline uint32_t MurmurHash3_x32_32(
         const void* key, const uint32_t len, const uint32_t seed) {
-#ifdef SIMPLE_UNIFORM_NOISE_STAFF_GCC_WORKAROUND
-# pragma GCC pop_options
-#endif
     constexpr uint32_t c1 = 0xCC9E2D51;
     constexpr uint32_t c2 = 0x1B873593;
     uint32_t h1 = seed;
-    const uint32_t* data = static_cast<const uint32_t*>(key);
-    const uint32_t* end = data + (len >> 2);
+    const uint8_t* data = static_cast<const uint8_t*>(key);
+    const uint8_t* end = data + (len & ~3u);
     while (data != end) {
-        uint32_t k1 = *data++;
-        k1 *= c1;
-        k1 = (k1 << 15) | (k1 >> (32 - 15));
-        k1 *= c2;
-        h1 ^= k1;
-        h1 = (h1 << 13) | (h1 >> (32 - 13));
-        h1 = h1 * 5 + 0xE6546B64;
+        uint32_t k1;
+        std::memcpy(&k1, data, sizeof(k1));
+        data += sizeof(k1);
+        h1 = detail::MurmurHash3_x32_32_round(h1, k1);
     }
-    const uint8_t* tail = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* tail = data;
     uint32_t k1 = 0;
     switch (len & 3) {
     case 3: k1 ^= static_cast<uint32_t>(tail[2]) << 16; [[fallthrough]];
@@ -147,14 +171,291 @@ inline uint32_t MurmurHash3_x32_32(
         k1 *= c2;
         h1 ^= k1;
     };
-    h1 ^= len;
-    h1 ^= h1 >> 16;
-    h1 *= 0x85EBCA6B;
-    h1 ^= h1 >> 13;
-    h1 *= 0xC2B2AE35;
-    h1 ^= h1 >> 16;
+    return detail::MurmurHash3_x32_32_final(h1, len);
+}
+
+// Fixed-arity keys of 1..4 uint64_t words, e.g. MurmurHash3_x32_32(x, y, seed)
+// is the same as MurmurHash3_x32_32(uint64_t[2]{ x, y }, 16, seed).
+inline constexpr uint32_t MurmurHash3_x32_32(
+        const uint64_t k0, const uint32_t seed) noexcept {
+    uint32_t h1 = seed;
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k0);
+    return detail::MurmurHash3_x32_32_final(h1, 1 * sizeof(uint64_t));
+}
+inline constexpr uint32_t MurmurHash3_x32_32(
+        const uint64_t k0, const uint64_t k1, const uint32_t seed) noexcept {
+    uint32_t h1 = seed;
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k0);
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k1);
+    return detail::MurmurHash3_x32_32_final(h1, 2 * sizeof(uint64_t));
+}
+inline constexpr uint32_t MurmurHash3_x32_32(
+        const uint64_t k0, const uint64_t k1, const uint64_t k2, const uint32_t seed) noexcept {
+    uint32_t h1 = seed;
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k0);
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k1);
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k2);
+    return detail::MurmurHash3_x32_32_final(h1, 3 * sizeof(uint64_t));
+}
+inline constexpr uint32_t MurmurHash3_x32_32(
+        const uint64_t k0, const uint64_t k1, const uint64_t k2, const uint64_t k3,
+        const uint32_t seed) noexcept {
+    uint32_t h1 = seed;
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k0);
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k1);
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k2);
+    h1 = detail::MurmurHash3_x32_32_mix(h1, k3);
+    return detail::MurmurHash3_x32_32_final(h1, 4 * sizeof(uint64_t));
+}
+
+namespace detail {
+
+#if defined(__SSE4_1__)
+inline __m128i rotl_u32(const __m128i x, const int r) noexcept {
+    return _mm_or_si128(_mm_slli_epi32(x, r), _mm_srli_epi32(x, 32 - r));
+}
+inline __m128i MurmurHash3_x32_32_round(__m128i h1, __m128i k1) noexcept {
+    k1 = _mm_mullo_epi32(k1, _mm_set1_epi32(0xCC9E2D51));
+    k1 = rotl_u32(k1, 15);
+    k1 = _mm_mullo_epi32(k1, _mm_set1_epi32(0x1B873593));
+    h1 = _mm_xor_si128(h1, k1);
+    h1 = rotl_u32(h1, 13);
+    h1 = _mm_add_epi32(_mm_add_epi32(h1, _mm_slli_epi32(h1, 2)), _mm_set1_epi32(0xE6546B64));
     return h1;
 }
+inline __m128i MurmurHash3_x32_32_final(__m128i h1, const uint32_t len) noexcept {
+    h1 = _mm_xor_si128(h1, _mm_set1_epi32(len));
+    h1 = _mm_xor_si128(h1, _mm_srli_epi32(h1, 16));
+    h1 = _mm_mullo_epi32(h1, _mm_set1_epi32(0x85EBCA6B));
+    h1 = _mm_xor_si128(h1, _mm_srli_epi32(h1, 13));
+    h1 = _mm_mullo_epi32(h1, _mm_set1_epi32(0xC2B2AE35));
+    h1 = _mm_xor_si128(h1, _mm_srli_epi32(h1, 16));
+    return h1;
+}
+template <uint32_t words>
+inline __m128i MurmurHash3_x32_32_x4(const uint64_t* keys, const uint32_t seed) noexcept {
+    __m128i h1 = _mm_set1_epi32(seed);
+    for (uint32_t w = 0; w < words; ++w) {
+        const __m128 a = _mm_castsi128_ps(_mm_set_epi64x(
+            keys[1 * words + w], keys[0 * words + w]));
+        const __m128 b = _mm_castsi128_ps(_mm_set_epi64x(
+            keys[3 * words + w], keys[2 * words + w]));
+        const __m128i lo = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i hi = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        h1 = MurmurHash3_x32_32_round(h1, lo);
+        h1 = MurmurHash3_x32_32_round(h1, hi);
+    }
+    return MurmurHash3_x32_32_final(h1, words * sizeof(uint64_t));
+}
+#endif // __SSE4_1__
+
+#if defined(__AVX2__)
+inline __m256i rotl_u32(const __m256i x, const int r) noexcept {
+    return _mm256_or_si256(_mm256_slli_epi32(x, r), _mm256_srli_epi32(x, 32 - r));
+}
+inline __m256i MurmurHash3_x32_32_round(__m256i h1, __m256i k1) noexcept {
+    k1 = _mm256_mullo_epi32(k1, _mm256_set1_epi32(0xCC9E2D51));
+    k1 = rotl_u32(k1, 15);
+    k1 = _mm256_mullo_epi32(k1, _mm256_set1_epi32(0x1B873593));
+    h1 = _mm256_xor_si256(h1, k1);
+    h1 = rotl_u32(h1, 13);
+    h1 = _mm256_add_epi32(_mm256_add_epi32(h1, _mm256_slli_epi32(h1, 2)), _mm256_set1_epi32(0xE6546B64));
+    return h1;
+}
+inline __m256i MurmurHash3_x32_32_final(__m256i h1, const uint32_t len) noexcept {
+    h1 = _mm256_xor_si256(h1, _mm256_set1_epi32(len));
+    h1 = _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 16));
+    h1 = _mm256_mullo_epi32(h1, _mm256_set1_epi32(0x85EBCA6B));
+    h1 = _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 13));
+    h1 = _mm256_mullo_epi32(h1, _mm256_set1_epi32(0xC2B2AE35));
+    h1 = _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 16));
+    return h1;
+}
+template <uint32_t words>
+inline __m256i MurmurHash3_x32_32_x8(const uint64_t* keys, const uint32_t seed) noexcept {
+    const __m256i idx = _mm256_setr_epi64x(0, words, 2 * words, 3 * words);
+    const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    __m256i h1 = _mm256_set1_epi32(seed);
+    for (uint32_t w = 0; w < words; ++w) {
+        const long long* base = reinterpret_cast<const long long*>(keys + w);
+        // [lo0 lo1 lo2 lo3 hi0 hi1 hi2 hi3]
+        const __m256i a = _mm256_permutevar8x32_epi32(
+            _mm256_i64gather_epi64(base, idx, 8), deinterleave);
+        // [lo4 lo5 lo6 lo7 hi4 hi5 hi6 hi7]
+        const __m256i b = _mm256_permutevar8x32_epi32(
+            _mm256_i64gather_epi64(base + 4 * words, idx, 8), deinterleave);
+        h1 = MurmurHash3_x32_32_round(h1, _mm256_permute2x128_si256(a, b, 0x20));
+        h1 = MurmurHash3_x32_32_round(h1, _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    return MurmurHash3_x32_32_final(h1, words * sizeof(uint64_t));
+}
+#endif // __AVX2__
+
+#if defined(__AVX512F__)
+inline __m512i MurmurHash3_x32_32_round(__m512i h1, __m512i k1) noexcept {
+    k1 = _mm512_mullo_epi32(k1, _mm512_set1_epi32(0xCC9E2D51));
+    k1 = _mm512_rol_epi32(k1, 15);
+    k1 = _mm512_mullo_epi32(k1, _mm512_set1_epi32(0x1B873593));
+    h1 = _mm512_xor_si512(h1, k1);
+    h1 = _mm512_rol_epi32(h1, 13);
+    h1 = _mm512_add_epi32(_mm512_add_epi32(h1, _mm512_slli_epi32(h1, 2)), _mm512_set1_epi32(0xE6546B64));
+    return h1;
+}
+inline __m512i MurmurHash3_x32_32_final(__m512i h1, const uint32_t len) noexcept {
+    h1 = _mm512_xor_si512(h1, _mm512_set1_epi32(len));
+    h1 = _mm512_xor_si512(h1, _mm512_srli_epi32(h1, 16));
+    h1 = _mm512_mullo_epi32(h1, _mm512_set1_epi32(0x85EBCA6B));
+    h1 = _mm512_xor_si512(h1, _mm512_srli_epi32(h1, 13));
+    h1 = _mm512_mullo_epi32(h1, _mm512_set1_epi32(0xC2B2AE35));
+    h1 = _mm512_xor_si512(h1, _mm512_srli_epi32(h1, 16));
+    return h1;
+}
+template <uint32_t words>
+inline __m512i MurmurHash3_x32_32_x16(const uint64_t* keys, const uint32_t seed) noexcept {
+    const __m512i idx = _mm512_setr_epi64(
+        0, words, 2 * words, 3 * words, 4 * words, 5 * words, 6 * words, 7 * words);
+    const __m512i lo = _mm512_setr_epi32(
+        0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i hi = _mm512_setr_epi32(
+        1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i h1 = _mm512_set1_epi32(seed);
+    for (uint32_t w = 0; w < words; ++w) {
+        const __m512i a = _mm512_mask_i64gather_epi64(zero, 0xFF, idx, keys + w, 8);
+        const __m512i b = _mm512_mask_i64gather_epi64(zero, 0xFF, idx, keys + 8 * words + w, 8);
+        h1 = MurmurHash3_x32_32_round(h1, _mm512_permutex2var_epi32(a, lo, b));
+        h1 = MurmurHash3_x32_32_round(h1, _mm512_permutex2var_epi32(a, hi, b));
+    }
+    return MurmurHash3_x32_32_final(h1, words * sizeof(uint64_t));
+}
+#endif // __AVX512F__
+
+} // namespace detail
+
+// Hashes `count` keys of `words` uint64_t each, stored one after another.
+// out[i] == MurmurHash3_x32_32(keys + i * words, words * sizeof(uint64_t), seed),
+// 16/8/4 keys at a time with AVX-512/AVX2/SSE4.1 if enabled by the compiler.
+template <uint32_t words>
+inline void MurmurHash3_x32_32_batch(
+        const uint64_t* keys, const size_t count, const uint32_t seed, uint32_t* out) noexcept {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i < (count & ~size_t(15)); i += 16) {
+        _mm512_storeu_si512(out + i, detail::MurmurHash3_x32_32_x16<words>(keys + i * words, seed));
+    }
+#endif
+#if defined(__AVX2__)
+    for (; i < (count & ~size_t(7)); i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+            detail::MurmurHash3_x32_32_x8<words>(keys + i * words, seed));
+    }
+#endif
+#if defined(__SSE4_1__)
+    for (; i < (count & ~size_t(3)); i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+            detail::MurmurHash3_x32_32_x4<words>(keys + i * words, seed));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = detail::MurmurHash3_x32_32_words<words>(keys + i * words, seed);
+    }
+}
+
+// Hashes of the 2^N keys of N words where word k of key c is hi[k] if bit k
+// of c is set and lo[k] otherwise, e.g. the corners of a lattice cell. The
+// same as MurmurHash3_x32_32_batch<N> over these keys, but each shared key
+// prefix is mixed once: 2 * (2^(N+1) - 2) rounds instead of 2 * N * 2^N.
+template <uint32_t N>
+inline void MurmurHash3_x32_32_prefix(const uint64_t (&lo)[N], const uint64_t (&hi)[N],
+        const uint32_t seed, uint32_t (&out)[1u << N]) noexcept {
+    out[0] = seed;
+    for (uint32_t k = 0; k < N; ++k) {
+        for (uint32_t c = 0; c < (1u << k); ++c) {
+            out[c + (1u << k)] = detail::MurmurHash3_x32_32_mix(out[c], hi[k]);
+            out[c] = detail::MurmurHash3_x32_32_mix(out[c], lo[k]);
+        }
+    }
+    for (uint32_t c = 0; c < (1u << N); ++c) {
+        out[c] = detail::MurmurHash3_x32_32_final(out[c], N * sizeof(uint64_t));
+    }
+}
+
+inline uint64_t mulhi_u64(const uint64_t a, const uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128_t;
+    return static_cast<uint64_t>((static_cast<uint128_t>(a) * b) >> 64);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    return __umulh(a, b);
+#else
+    const uint64_t a_lo = a & UINT32_MAX;
+    const uint64_t a_hi = a >> 32;
+    const uint64_t b_lo = b & UINT32_MAX;
+    const uint64_t b_hi = b >> 32;
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    const uint64_t hi_hi = a_hi * b_hi;
+    const uint64_t mid = (lo_lo >> 32) + (hi_lo & UINT32_MAX) + lo_hi;
+    return hi_hi + (hi_lo >> 32) + (mid >> 32);
+#endif
+}
+
+// Division of uint64_t by a runtime-invariant divisor with a multiply-shift,
+// see Granlund & Montgomery "Division by Invariant Integers using Multiplication"
+// and libdivide. divide(n) == n / d for every n.
+class divider_u64 {
+public:
+    divider_u64() = default;
+    divider_u64(const uint64_t d) noexcept {
+        set(d);
+    }
+    void set(const uint64_t d) noexcept { // 1..UINT64_MAX
+        m_shift = 0;
+        while ((d >> m_shift) > 1) {
+            ++m_shift;
+        }
+        m_add = false;
+        if ((d & (d - 1)) == 0) {
+            m_magic = 0;
+            return;
+        }
+        // 2^(64 + shift) / d, the quotient fits since d > 2^shift.
+        uint64_t quotient = 0;
+        uint64_t remainder = UINT64_C(1) << m_shift;
+        for (uint32_t i = 0; i < 64; ++i) {
+            const bool carry = (remainder >> 63) != 0;
+            remainder <<= 1;
+            quotient <<= 1;
+            if (carry || remainder >= d) {
+                remainder -= d;
+                quotient |= 1;
+            }
+        }
+        if (d - remainder >= (UINT64_C(1) << m_shift)) {
+            quotient += quotient;
+            const uint64_t twice = remainder + remainder;
+            if (twice >= d || twice < remainder) {
+                quotient += 1;
+            }
+            m_add = true;
+        }
+        m_magic = quotient + 1;
+    }
+    uint64_t divide(const uint64_t n) const noexcept {
+        if (m_magic == 0) {
+            return n >> m_shift;
+        }
+        const uint64_t q = mulhi_u64(m_magic, n);
+        if (!m_add) {
+            return q >> m_shift;
+        }
+        return (((n - q) >> 1) + q) >> m_shift;
+    }
+private:
+    uint64_t m_magic = 0;
+    uint32_t m_shift = 0;
+    bool m_add = false;
+};
 
 class lcg32 {
 public:
@@ -211,12 +512,17 @@ public:
         m_x = value;
     }
     uint64_t operator()() noexcept {
+        m_x = mix(m_x);
+        return m_x;
+    }
+    // The step function, keyed by stream64 into a counter-based generator.
+    static constexpr uint64_t mix(const uint64_t x) noexcept {
         // MurmurHash64A
         constexpr uint64_t m = UINT64_C(0xC6A4A7935BD1E995);
         constexpr uint64_t m8 = sizeof(uint64_t) * UINT64_C(0xC6A4A7935BD1E995);
         constexpr uint64_t r = 47;
         uint64_t h = m8;
-        uint64_t k = m_x;
+        uint64_t k = x;
         k *= m;
         k ^= k >> r;
         k *= m;
@@ -225,13 +531,94 @@ public:
         h ^= h >> r;
         h *= m;
         h ^= h >> r;
-        m_x = h;
-        return m_x;
+        return h;
     }
 private:
     uint64_t m_x = 1;
 };
 
+namespace detail {
+#if defined(__AVX512DQ__)
+// rng64::mix((x + {0, 1, ..., 7}) ^ key)
+inline __m512i mix_x8(const uint64_t x, const uint64_t key) noexcept {
+    const __m512i m = _mm512_set1_epi64(static_cast<long long>(UINT64_C(0xC6A4A7935BD1E995)));
+    const __m512i m8 = _mm512_set1_epi64(static_cast<long long>(8 * UINT64_C(0xC6A4A7935BD1E995)));
+    __m512i k = _mm512_add_epi64(_mm512_set1_epi64(static_cast<long long>(x)),
+        _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+    k = _mm512_xor_si512(k, _mm512_set1_epi64(static_cast<long long>(key)));
+    k = _mm512_mullo_epi64(k, m);
+    k = _mm512_xor_si512(k, _mm512_srli_epi64(k, 47));
+    k = _mm512_mullo_epi64(k, m);
+    __m512i h = _mm512_xor_si512(m8, k);
+    h = _mm512_mullo_epi64(h, m);
+    h = _mm512_xor_si512(h, _mm512_srli_epi64(h, 47));
+    h = _mm512_mullo_epi64(h, m);
+    return _mm512_xor_si512(h, _mm512_srli_epi64(h, 47));
+}
+#endif // __AVX512DQ__
+} // namespace detail
+
+// Counter-based generator: value i of substream s is
+// rng64::mix((s * s_streamLength + i) ^ rng64::mix(seed)). The seed is a
+// key, not a start position: the streams of different seeds are unrelated,
+// not shifted copies of each other. The substreams of one seed are disjoint
+// ranges of 2^40 values, substream s continues into s + 1. Any position is
+// reached in O(1), so threads can generate disjoint parts of one sequence
+// or their own substreams split() from one seed, with the same result for
+// any thread count.
+class stream64 {
+public:
+    static constexpr uint64_t s_streamLength = UINT64_C(1) << 40;
+
+    stream64() = default;
+    explicit stream64(const uint64_t seed, const uint64_t stream = 0) noexcept
+        : m_key(rng64::mix(seed)), m_counter(stream * s_streamLength) {
+    }
+    // The substream of the same seed.
+    stream64 split(const uint64_t stream) const noexcept {
+        stream64 other = *this;
+        other.m_counter = stream * s_streamLength;
+        return other;
+    }
+    // Position relative to the start of substream 0.
+    uint64_t position() const noexcept {
+        return m_counter;
+    }
+    void seek(const uint64_t position) noexcept {
+        m_counter = position;
+    }
+    void discard(const uint64_t count) noexcept {
+        m_counter += count;
+    }
+    uint64_t operator()() noexcept {
+        return rng64::mix(m_counter++ ^ m_key);
+    }
+    void fill(uint64_t* out, const size_t count) noexcept {
+        const uint64_t x = m_counter;
+        size_t idx = 0;
+        // The values are independent, so the scalar loop already overlaps
+        // the multiplications. Without 64-bit vector multiplication (AVX2)
+        // the emulation is slower than the scalar loop.
+#if defined(__AVX512DQ__)
+        for (; idx + 8 <= count; idx += 8) {
+            _mm512_storeu_si512(out + idx, detail::mix_x8(x + idx, m_key));
+        }
+#endif
+        for (; idx < count; ++idx) {
+            out[idx] = rng64::mix((x + idx) ^ m_key);
+        }
+        m_counter += count;
+    }
+#if __cplusplus >= 202002L
+    void fill(const std::span<uint64_t> out) noexcept {
+        fill(out.data(), out.size());
+    }
+#endif
+private:
+    uint64_t m_key = rng64::mix(0);
+    uint64_t m_counter = 0;
+};
+
 // from_a  from_t  from_b
 //  to_a   result   to_b
 inline constexpr uint32_t lerp_u32(
@@ -274,6 +661,18 @@ inline constexpr uint32_t lerp_u32(
     }
 }
 //   0   from_t  from_b
+// to_a  result   to_b
+inline uint32_t lerp_u32(
+        const uint32_t from_t, const divider_u64& from_b,
+        const uint32_t to_a, const uint32_t to_b) noexcept {
+    // Same rounding as the constexpr version, but a single division and a select.
+    const uint64_t from_t_ = from_t;
+    const bool rising = to_a < to_b;
+    const uint32_t distance = rising ? to_b - to_a : to_a - to_b;
+    const uint32_t step = static_cast<uint32_t>(from_b.divide(from_t_ * distance));
+    return rising ? to_a + step : to_a - step;
+}
+//   0   from_t  from_b
 //   0   result   to_b
 inline constexpr uint32_t lerp_u32(
         const uint32_t from_t, const uint32_t from_b,